@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+// Counts heap allocations (global operator new) made by the calling thread, to
+// check that steady-state frames don't allocate. Only active when
+// PLATFORMER_COUNT_ALLOCATIONS is defined (Debug configurations), otherwise
+// the counts stay 0 and operator new isn't replaced.
+namespace AllocationCounter {
+	bool Enabled();
+	uint64_t ThreadAllocations(); // since the thread started
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "ThreadPool.h"
+
+// Everything an asset needs done on the GL thread once its files are read,
+// in order (shader compiles, buffer & texture uploads, ...)
+class AssetUploads {
+public:
+	void Stage(std::function<void()> upload) {uploads.push_back(std::move(upload));}
+
+
+private:
+	friend class AssetLoader;
+	std::deque<std::function<void()>> uploads;
+};
+
+
+// Loads assets in two stages: file I/O, decompression and other CPU work run
+// on the thread pool, the GL work they stage runs on the main thread within a
+// per-frame time budget, so the window keeps drawing while assets stream in.
+class AssetLoader {
+public:
+	// Functions
+	void Setup(ThreadPool* workerPool, double uploadBudgetMs);
+
+	// work runs on a worker and returns false (or throws) on failure; uploads it stages run in Update()
+	void Load(const char* name, std::function<bool(AssetUploads&)> work);
+
+	void Update(); // main thread, once per frame
+	float Progress() const; // 0..1
+	bool IsDone() const;
+	bool Failed() const;
+
+
+private:
+	struct Asset {
+		std::string name;
+		AssetUploads uploads;
+		size_t numOfUploads = 0;
+		size_t uploadsDone = 0;
+		std::atomic<bool> read {false};
+		bool failed = false;
+		std::string error; // what a throwing stage threw
+	};
+
+	// Members
+	ThreadPool* pool;
+	double uploadBudget; // seconds
+
+	std::vector<std::shared_ptr<Asset>> assets; // main thread only
+	std::deque<std::shared_ptr<Asset>> readyToUpload;
+	mutable std::mutex readyMutex;
+	size_t numOfFinished = 0;
+	bool anyFailed = false;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+
+#include "Level.h"
+#include "PlayerPhysics.h"
+#include "ThreadPool.h"
+
+// Many independent copies of the game stepped together, for training agents.
+// Instance state lives in parallel arrays (one entry per instance) and every
+// tick runs the same PlayerPhysics as the game, so a policy sees exactly the
+// movement and collisions it will get in the real thing.
+//
+// Each Step() takes one action per instance (Input_Bits, like the keyboard),
+// advances every instance by one fixed tick and writes, per instance:
+//   observations[i * observationSize ...] see Observation_Layout
+//   rewards[i]  height gained above the best height so far this episode
+//   dones[i]    1 when the episode ended (timed out or reached the top);
+//               the instance is already reset and its observation is the new start
+//
+// The level is shared by all instances and only read, so it must not be changed
+// (e.g. by moving platforms) while stepping; movers stay where the level has them.
+// Its number of platforms is fixed at Setup, which sizes the scratch memory.
+class BatchEnvironment {
+public:
+	enum Observation_Layout {
+		OBS_POSITION_X, OBS_POSITION_Y, OBS_VELOCITY_Y, OBS_ON_GROUND, OBS_HYPER, OBS_TIRED, OBS_TIMER,
+		OBS_PLATFORMS, // then numOfNearbyPlatforms x (left, right, lower, upper) relative to the player, nearest first
+	};
+	static const int numOfNearbyPlatforms = 4;
+	static const int observationSize = OBS_PLATFORMS + 4 * numOfNearbyPlatforms;
+
+	// Functions
+	bool Setup(const Level *envLevel, ThreadPool *workerPool, int instances, float radius, double ticksPerSecond, unsigned int maxTicks);
+	void Reset(float *observations); // starts a new episode on every instance
+	void Step(const unsigned int *actions, float *observations, float *rewards, unsigned char *dones);
+
+	int NumOfInstances() const {return numOfInstances;}
+
+
+private:
+	// Members
+	const Level* level;
+	ThreadPool* pool;
+	PlayerParameters parameters;
+	PlayerState spawnState;
+	float tickDelta;
+	unsigned int maxEpisodeTicks;
+	int numOfInstances = 0;
+
+	// Instance state
+	std::vector<float> positionX, positionY, velocityY, timer, speedup;
+	std::vector<unsigned char> tired, onGround;
+	std::vector<float> bestHeight;
+	std::vector<unsigned int> episodeTicks;
+
+	// Squared distance to every platform, one slice per chunk of instances so workers never share or allocate one
+	std::vector<float> distanceScratch;
+	int numOfPlatforms = 0;
+
+	// Functions
+	void StepRange(size_t begin, size_t end, const unsigned int *actions, float *observations, float *rewards, unsigned char *dones);
+	float* ChunkScratch(size_t begin);
+	void ResetInstance(size_t i);
+	PlayerState LoadState(size_t i) const;
+	void StoreState(size_t i, const PlayerState &state);
+	void Observe(size_t i, float *observation, float *distance) const;
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <GLM/glm.hpp>
+
+#include "CollisionWorld.h"
+
+// 2D camera over a world bigger than the screen. The view is a fixed size
+// rectangle in world units (2 x 2 shows exactly the old NDC screen); its
+// view-projection matrix goes to every world-space vertex shader.
+// The view is snapped to whole pixels, so cached layers can be blitted at
+// integer offsets and still line up with what is drawn live.
+class Camera {
+public:
+	// Functions
+	void Setup(glm::vec2 viewSize, int framebufferWidth, int framebufferHeight);
+	void Resize(int framebufferWidth, int framebufferHeight);
+	void SetBounds(const Collider &worldBounds); // the view never leaves this box (when it fits)
+	void SetPosition(glm::vec2 center);
+	void Follow(glm::vec2 target, float deltaTime); // keeps the target inside a dead zone around the center
+
+	glm::vec2 GetPosition() const {return position;}
+	glm::vec4 ViewRegion() const; // left, bottom, right, top
+	glm::mat4 ViewProjection() const;
+	bool IsVisible(const Collider &box) const;
+
+	static glm::mat4 ViewProjection(glm::vec4 region);
+	static bool Overlaps(glm::vec4 region, const Collider &box);
+
+
+private:
+	// Members
+	glm::vec2 viewSize;
+	glm::vec2 position = glm::vec2(0.0f);
+	glm::vec2 pixelSize; // world units per pixel
+	Collider bounds = {-1.0f, 1.0f, -1.0f, 1.0f};
+
+	glm::vec2 deadZone = glm::vec2(0.2f, 0.25f); // half size, in world units
+	float followSpeed = 8.0f; // fraction of the distance outside the dead zone closed per second
+
+	// Functions
+	void Constrain();
+};
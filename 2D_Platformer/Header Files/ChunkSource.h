@@ -0,0 +1,12 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <GLM/glm.hpp>
+
+#include "CollisionWorld.h"
+
+// Fills platforms (world space instances, xy = center, zw = size) for the chunk
+// covering region. Runs on a worker thread, so it must not touch OpenGL.
+// Called for several chunks at once from different workers.
+typedef std::function<void(glm::ivec2 chunk, const Collider &region, std::vector<glm::vec4> &platforms)> ChunkSource;
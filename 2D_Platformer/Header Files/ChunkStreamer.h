@@ -0,0 +1,96 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <functional>
+#include <GLM/glm.hpp>
+
+#include "Level.h"
+#include "CollisionWorld.h"
+#include "ChunkSource.h"
+#include "ShaderProgram.h"
+#include "ThreadPool.h"
+
+struct ChunkStreamingSettings {
+	glm::vec2 chunkSize = glm::vec2(2.0f, 2.0f); // world units, chunk (0, 0) starts at the origin
+	int loadRadius = 1;        // chunks kept loaded around the focus on each side
+	int maxChunks = 64;        // chunk slots, created up front
+	size_t memoryBudget = 4 * 1024 * 1024; // bytes of resident chunk data (CPU & GPU) before distant chunks are evicted
+	double uploadBudgetMs = 1.0; // GL upload time per frame, at least one chunk is uploaded
+};
+
+enum Chunk_State {CHUNK_FREE, CHUNK_LOADING, CHUNK_LOADED, CHUNK_RESIDENT};
+
+
+// Streams a world too big to keep in memory in fixed-size chunks around a
+// focus point (the camera). Chunks are loaded or generated by a ChunkSource on
+// the worker threads, uploaded a few per frame, and the farthest ones are
+// evicted when the slots run out or resident data goes over the memory budget.
+// All chunk storage is a fixed set of slots reused in place, so memory and
+// per-frame cost stay the same however far the player travels.
+// The base level adds its own platforms and supplies the bounds; collisions see
+// only the base level and resident chunks. QueryColliders may run on the
+// simulation thread while the main thread calls Update.
+class ChunkStreamer : public CollisionWorld {
+public:
+	// Functions
+	void Setup(const ShaderSources& shaderSources, const ChunkStreamingSettings& streamingSettings = ChunkStreamingSettings()); // GL objects for every slot
+	void Start(ThreadPool* workerPool, const Level* level, ChunkSource chunkSource);
+	bool Update(glm::vec2 focus); // main thread, once per frame; true when the resident chunks changed
+	void Draw(glm::vec4 region, const glm::mat4& viewProjection); // resident chunks overlapping region
+	void Delete(); // after the worker pool has shut down
+
+	glm::ivec2 ChunkAt(glm::vec2 position) const;
+	Collider ChunkRegion(glm::ivec2 chunk) const;
+	int NumOfResident() const {return numOfResident;}
+	size_t ResidentBytes() const {return residentBytes;}
+
+	Collider Bounds() const override;
+	int QueryColliders(glm::vec2 center, float reach, float velocityY, Collider* colliders, int maxColliders) const override;
+
+	// Reads chunk (x, y) from "<directory>/<x>_<y>.lvl", platform coordinates
+	// relative to the chunk's lower left corner; a missing file is an empty chunk
+	static ChunkSource LevelFiles(const std::string& directory);
+
+
+private:
+	// One reusable chunk slot. A worker only writes a slot while it is loading,
+	// the simulation only reads it while it is resident.
+	struct ChunkSlot {
+		glm::ivec2 chunk;
+		Chunk_State state = CHUNK_FREE;
+		std::vector<glm::vec4> platforms;
+		std::vector<Collider> colliders;
+		Collider extent; // union of the colliders, may reach past the chunk's region
+		size_t bytes = 0;
+		bool resident = false; // changed under residentMutex, the simulation skips the slot while false
+		unsigned int vaoId, instanceVBO;
+	};
+
+	// Members
+	ThreadPool* pool;
+	const Level* baseLevel;
+	ChunkSource source;
+	ChunkStreamingSettings settings;
+	ShaderProgram shaderProgram;
+	unsigned int quadVBO, quadEBO;
+
+	std::vector<ChunkSlot> slots;
+	std::vector<glm::ivec2> loadOffsets; // around the focus, nearest first
+	int numOfResident = 0;
+	size_t residentBytes = 0;
+
+	std::vector<int> finished; // slots whose source has run, guarded by finishedMutex
+	std::vector<int> finishedSwap;
+	std::mutex finishedMutex;
+	mutable std::mutex residentMutex; // held while the simulation reads resident slots or the main thread changes them
+
+	// Functions
+	int FindSlot(glm::ivec2 chunk) const; // -1 when the chunk has none
+	int FreeSlot() const;
+	int FarthestSlot(glm::ivec2 focusChunk, bool onlyOutsideRadius) const;
+	void Request(int slot, glm::ivec2 chunk);
+	void Upload(int slot);
+	void Evict(int slot);
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <vector>
+#include <GLM/glm.hpp>
+
+#include "ShaderProgram.h"
+#include "ShaderVariants.h"
+
+// Draws circles as instanced quads. The fragment shader evaluates the circle's
+// signed distance, so every circle costs 4 vertices whatever its radius and
+// gets an anti-aliased edge.
+class CircleBatch {
+public:
+	// Functions
+	void Setup(const ShaderSources& shaderSources, unsigned int initialCapacity = 64);
+	void Add(glm::vec2 center, float radius);
+	void Draw(bool hyper, const glm::mat4& viewProjection);
+	void DeleteVAO();
+
+
+private:
+	// Members
+	unsigned int vaoId, quadVBO, quadEBO, instanceVBO;
+	unsigned int capacity;
+	ShaderVariants shaderVariants; // HYPER on/off
+	std::vector<glm::vec3> instances; // xy = center, z = radius
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <GLM/glm.hpp>
+
+// Axis-aligned box a player can collide with
+struct Collider {
+	float leftSide, rightSide, lowerSide, upperSide;
+};
+
+// What a player collides with. Level (free rectangles) and TileMap (grid of
+// cells) both answer the same two questions, so the physics doesn't care which
+// kind of world it runs in and both can be used side by side.
+class CollisionWorld {
+public:
+	virtual ~CollisionWorld() = default;
+
+	// Functions
+	virtual Collider Bounds() const = 0; // walls, ground line (lowerSide) and ceiling the player is kept within
+	// Writes the colliders within reach (half extent of a square) of center, at most maxColliders.
+	// Returns how many there are; when that is more than maxColliders, some were left out
+	// and a buffer of the returned size holds them all.
+	// One-way surfaces are only included for a player above them and not moving up.
+	virtual int QueryColliders(glm::vec2 center, float reach, float velocityY, Collider* colliders, int maxColliders) const = 0;
+};
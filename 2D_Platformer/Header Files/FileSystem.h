@@ -0,0 +1,73 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "MappedFile.h"
+
+// Asset pack layout: header, entry table (sorted by path), then the entries'
+// data, each starting at a 64 byte aligned offset.
+struct AssetPackHeader {
+	char magic[4];         // "APAK"
+	uint32_t version;
+	uint32_t numOfEntries;
+	uint32_t reserved;
+	uint64_t entriesOffset; // AssetPackEntry [numOfEntries]
+};
+
+struct AssetPackEntry {
+	char path[112];       // relative, forward slashes, e.g. "Shaders/circleShader.vs"
+	uint64_t offset;
+	uint32_t storedSize;  // bytes in the pack
+	uint32_t size;        // bytes once decompressed
+	uint32_t hash;        // FNV-1a of the decompressed bytes
+	uint32_t flags;
+};
+
+const uint32_t assetPackVersion = 1;
+const uint32_t assetCompressedFlag = 1; // stored as an LZ4 block
+const uint64_t assetPackAlignment = 64;
+
+uint32_t HashBytes(const unsigned char* bytes, size_t size);
+// Whether count elements of elementSize bytes at offset lie inside a file of fileSize
+// bytes. Safe for any offset & count read from a corrupt file, nothing can wrap.
+bool SectionInside(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t fileSize);
+
+
+// Bytes of one asset. Points straight into the mounted pack when the asset is
+// stored uncompressed, otherwise into memory owned by this object.
+class FileData {
+public:
+	unsigned char* data = nullptr;
+	size_t size = 0;
+
+	std::string Text() const;
+	void Release();
+
+
+private:
+	friend class FileSystem;
+	std::vector<unsigned char> storage;
+	MappedFile mapping;
+};
+
+
+// Virtual file system: assets are looked up in the mounted pack first and
+// read from loose files (relative to the working directory) otherwise.
+// Reading is thread-safe once the pack is mounted.
+class FileSystem {
+public:
+	static bool Mount(const char* packPath);
+	static void Unmount();
+	static bool ReadFile(const char* path, FileData& file);
+	static std::string ExecutableDirectory();
+
+
+private:
+	static MappedFile pack;
+	static const AssetPackEntry* entries;
+	static uint32_t numOfEntries;
+
+	static const AssetPackEntry* FindEntry(const char* path);
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+
+#include "FileSystem.h"
+
+// Baked font file (built by AssetCompiler): header, glyph metrics, kerning pairs
+// sorted by (left, right), then the atlas itself, one byte of coverage per pixel.
+// Advances are in 1/64 pixels like FreeType's, everything else in pixels.
+struct CompiledFontHeader {
+	char magic[4];          // "FNTA"
+	uint32_t version;
+	uint32_t pixelHeight;
+	uint32_t atlasWidth;
+	uint32_t atlasHeight;
+	uint32_t numOfGlyphs;
+	uint32_t numOfKerningPairs;
+	uint32_t reserved;
+	uint64_t glyphsOffset;  // CompiledGlyph [numOfGlyphs]
+	uint64_t kerningOffset; // CompiledKerningPair [numOfKerningPairs]
+	uint64_t pixelsOffset;  // unsigned char [atlasWidth * atlasHeight], rows top to bottom
+};
+
+struct CompiledGlyph {
+	uint32_t character;
+	uint16_t atlasX, atlasY; // top left corner in the atlas
+	int16_t width, height;
+	int16_t bearingX, bearingY;
+	int32_t advance;
+};
+
+struct CompiledKerningPair {
+	uint32_t left, right;
+	int32_t advance; // added to the left character's advance
+};
+
+const uint32_t compiledFontVersion = 1;
+
+
+// A baked font read with a single file read. The tables point straight into the file.
+class FontAtlas {
+public:
+	const CompiledFontHeader* header = nullptr;
+	const CompiledGlyph* glyphs = nullptr;
+	const CompiledKerningPair* kerningPairs = nullptr;
+	const unsigned char* pixels = nullptr;
+
+	bool Load(const char* path); // any thread
+
+
+private:
+	FileData file;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// Bump allocator for data that only lives until the end of the frame.
+// Allocating is a pointer increment, nothing is freed individually, Reset()
+// (right after glfwSwapBuffers) releases everything at once. When a frame
+// needs more than the capacity the extra comes from the heap and the arena
+// grows at the next Reset, so steady-state frames never touch the heap.
+class FrameArena {
+public:
+	// Functions
+	void Setup(size_t initialCapacity);
+	void* Allocate(size_t size, size_t alignment);
+	void Reset();
+	void Shutdown();
+
+	size_t Used() const {return offset + overflowBytes;}
+	size_t Capacity() const {return capacity;}
+
+
+private:
+	// Members
+	unsigned char* memory = nullptr;
+	size_t capacity = 0, offset = 0;
+	std::vector<void*> overflowBlocks;
+	size_t overflowBytes = 0;
+};
+
+
+// Standard allocator handing out frame arena memory, for containers that die with the frame
+template <typename T>
+class ArenaAllocator {
+public:
+	typedef T value_type;
+
+	FrameArena* arena;
+
+	ArenaAllocator(FrameArena* frameArena) : arena(frameArena) {}
+	template <typename U> ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+	T* allocate(size_t n) {return (T*)arena->Allocate(n * sizeof(T), alignof(T));}
+	void deallocate(T*, size_t) {} // freed by FrameArena::Reset
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {return a.arena == b.arena;}
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {return a.arena != b.arena;}
+
+typedef std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>> ArenaString;
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <GLFW/glfw3.h>
+
+enum Vsync_Mode {VSYNC_OFF, VSYNC_ON, VSYNC_ADAPTIVE};
+
+// Caps the frame rate without burning a core: sleeps for most of the frame,
+// then spins for the last fraction of a millisecond to hit the deadline
+// accurately. Also tracks how far achieved frame times stray from the target.
+class FramePacer {
+public:
+	// Functions
+	void Setup(double targetFps, Vsync_Mode mode);
+	void SetTargetFps(double targetFps); // 0 = unlimited
+	void WaitForNextFrame();             // call right before glfwSwapBuffers
+
+	double GetAverageFrameTime(); // milliseconds
+	double GetJitter();           // standard deviation of frame time, milliseconds
+	void PrintReport();
+	void Shutdown();
+
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	// Members
+	Clock::duration framePeriod;
+	Clock::time_point nextDeadline, lastFrame;
+	bool limited = false;
+
+	// sleeping overshoots by roughly this much, spin instead of sleeping for the last part of the frame
+	double spinThreshold = 0.002;
+
+	// frame time statistics (Welford's online mean/variance)
+	long long frameCount = 0;
+	double meanFrameTime = 0.0, frameTimeM2 = 0.0, worstFrameTime = 0.0;
+
+	// Functions
+	void SetVsync(Vsync_Mode mode);
+	void RecordFrame(Clock::time_point now);
+};
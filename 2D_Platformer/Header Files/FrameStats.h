@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+
+enum Frame_Budget {BUDGET_60HZ, BUDGET_120HZ};
+
+// Frame time statistics over a whole run. Frame times go into an HDR-style
+// histogram: exact below 64 us, then 32 linear sub-buckets per power of two,
+// so every percentile is within ~3% of the true value. The 1024 32-bit counts
+// take 4 KB.
+class FrameStats {
+public:
+	// Functions
+	void Record(double frameTime); // seconds
+	void Reset();
+
+	uint64_t NumOfFrames() const {return numOfFrames;}
+	double Min() const;  // milliseconds, like everything below
+	double Max() const;
+	double Mean() const;
+	double Percentile(double percent) const; // e.g. 99.9
+	uint64_t MissedBudget(int budget) const {return missedBudgets[budget];}
+
+	void PrintReport() const;
+	bool WriteJson(const char* path) const;
+
+
+private:
+	static const int subBucketBits = 6; // values below 2^6 us are exact
+	static const int subBucketHalf = 1 << (subBucketBits - 1);
+	static const int maxShift = 30;     // up to 2^36 us (~19 hours), far beyond any frame
+	static const int numOfBuckets = (1 << subBucketBits) + maxShift * subBucketHalf;
+
+	// Members
+	uint32_t counts[numOfBuckets] = {}; // 4 billion frames per bucket is over 2 years at 60 Hz
+	uint64_t numOfFrames = 0;
+	uint64_t minMicroseconds = UINT64_MAX, maxMicroseconds = 0;
+	double sumMicroseconds = 0.0;
+	uint64_t missedBudgets[2] = {}; // frames over 16.6 ms (60 Hz) & 8.3 ms (120 Hz)
+
+	// Functions
+	static int BucketIndex(uint64_t microseconds);
+	static uint64_t BucketLowest(int index);
+	static uint64_t BucketHighest(int index);
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <GLM/glm.hpp>
+
+#include "ShaderProgram.h"
+#include "ParticleSystem.h"
+
+
+// One particle's state, as both shaders read it & the update writes it
+struct GpuParticle {
+	glm::vec4 motion; // xy = position, zw = velocity
+	glm::vec4 life;   // x = seconds left, y = 1 / lifetime, z = size
+};
+
+
+// Particles that live entirely on the GPU, for effects too big for the CPU
+// pools of ParticleSystem. Their state is in two buffers: every update a
+// vertex shader reads one, integrates each particle and writes the other
+// through transform feedback, then the quads are drawn straight from the new
+// state. Emitting restarts a window of slots with randoms hashed on the GPU;
+// the slots are a ring, so when all are alive the oldest go first.
+// The CPU only sets a few uniforms and issues two draws per frame, whatever
+// the capacity. Needs nothing past GL 3.3 core.
+class GpuParticleSystem {
+public:
+	// Functions
+	void Setup(const ShaderSources& updateSources, const ShaderSources& drawSources, const ParticleMaterial& particleMaterial, int particleCapacity = 262144);
+	void Emit(glm::vec2 position, int count); // all of an update's particles start where the last emit was
+	void Update(float deltaTime);
+	void Draw(const glm::mat4& viewProjection);
+	void DeleteVAO();
+
+	int Capacity() const;
+	unsigned int StateBuffer() const {return stateBuffers[current];} // latest state, GpuParticle [capacity], for tests & debugging
+
+
+private:
+	// Members
+	unsigned int stateBuffers[2], updateVaos[2], drawVaos[2]; // ping-pong, indexed by the buffer read
+	unsigned int quadVBO, quadEBO;
+	int current = 0; // buffer with the latest state
+	int capacity;
+	int spawnCursor = 0, pendingSpawns = 0;
+	unsigned int frame = 0; // seeds the GPU randoms
+	float quietTime; // simulated since the last spawn, once past the longest life there's nothing to do
+	glm::vec2 emitterPosition = glm::vec2(0.0f);
+	ParticleMaterial material;
+	ShaderProgram updateProgram, drawProgram;
+};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <GLM/glm.hpp>
+
 #include "ShaderProgram.h"
 
 class Ground {
@@ -7,16 +9,14 @@ public:
 	// Members
 	float upperSide, lowerSide, rightSide, leftSide;
 	
-	// Constructor
-	Ground(float positionAttribute[], unsigned int positionIndices[], const char* vrtxShaderPath, const char* frgmtShaderPath);
-	
 	// Functions
-	void Draw();
+	void Setup(float positionAttribute[], unsigned int positionIndices[], const ShaderSources& shaderSources);
+	void Draw(const glm::mat4& viewProjection);
 	void DeleteVAO();
 
 
 protected:
 	// Members
-	unsigned int vaoId;
+	unsigned int vaoId = 0;
 	ShaderProgram shaderProgram;
 };
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+// A key press or release, stamped when GLFW delivered it
+struct InputEvent {
+	std::chrono::steady_clock::time_point time;
+	unsigned int inputBit; // one of Input_Bits
+	bool pressed;
+};
+
+// Lock-free single-producer/single-consumer ring of input events.
+// The main thread pushes from the GLFW key callback, the simulation pops the
+// events that happened before the tick it is running. When full, new events
+// are dropped (the simulation empties it every tick, so that takes a stall of
+// hundreds of key presses).
+class InputQueue {
+public:
+	// Producer side
+	bool Push(const InputEvent& event) {
+		unsigned int tail = writeIndex.load(std::memory_order_relaxed);
+		if (tail - readIndex.load(std::memory_order_acquire) == capacity) return false;
+
+		events[tail % capacity] = event;
+		writeIndex.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer side: the oldest event, if any, without removing it
+	const InputEvent* Peek() {
+		unsigned int head = readIndex.load(std::memory_order_relaxed);
+		if (head == writeIndex.load(std::memory_order_acquire)) return nullptr;
+		return &events[head % capacity];
+	}
+
+	void Pop() {readIndex.store(readIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);}
+
+
+private:
+	static const unsigned int capacity = 256; // power of two, so indices can wrap
+
+	InputEvent events[capacity];
+	std::atomic<unsigned int> writeIndex {0}; // written by the producer
+	std::atomic<unsigned int> readIndex {0};  // written by the consumer
+};
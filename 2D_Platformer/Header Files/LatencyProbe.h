@@ -0,0 +1,58 @@
+#pragma once
+
+#include <deque>
+#include <chrono>
+#include <random>
+
+#include <GLAD/glad.h>
+
+#include "Simulation.h"
+#include "FrameStats.h"
+
+// Input-to-photon latency measurement. While enabled, injects a synthetic
+// INPUT_PROBE key press every few hundred milliseconds and follows it through
+// the pipeline: the simulation tick that applied it, the frame that first
+// showed that tick (CPU submit & swap), and when the GPU finished that frame
+// (GL_TIMESTAMP query, cross-checked with a fence). Display scan-out after the
+// GPU finishes isn't visible to the application and isn't included.
+class LatencyProbe {
+public:
+	// Functions
+	void SetEnabled(bool enable);
+	bool IsEnabled() const {return enabled;}
+
+	// main thread, in frame order
+	void Inject(Simulation& simulation, std::chrono::steady_clock::time_point previousPoll); // right after glfwPollEvents
+	void FrameSubmitted(const WorldSnapshot& world); // right before glfwSwapBuffers
+	void FrameSwapped();                             // right after glfwSwapBuffers
+	void Collect();                                  // reads finished GPU results, never blocks
+
+	void PrintReport() const;
+	void Shutdown();
+
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	struct Probe {
+		unsigned int id;
+		Clock::time_point pressTime, tickTime, submitTime, swapTime;
+		bool submitted = false, swapped = false;
+		GLuint query = 0;
+		GLsync fence = 0;
+		GLint64 gpuReference; // GPU clock (ns) at submitTime, to map the query result onto the CPU clock
+	};
+
+	// Members
+	bool enabled = false;
+	unsigned int numOfInjected = 0;
+	Clock::time_point nextInjection;
+	std::mt19937 random;
+	std::deque<Probe> pending;
+
+	// latency from the press to each stage (FrameStats as plain histograms)
+	FrameStats toTick, toSubmit, toSwap, toGpuDone, toFence;
+
+	// Functions
+	void Finish(Probe& probe, Clock::time_point gpuDone, Clock::time_point fenceSeen);
+};
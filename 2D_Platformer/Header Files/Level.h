@@ -0,0 +1,93 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <GLM/glm.hpp>
+
+#include "FileSystem.h"
+#include "CollisionWorld.h"
+
+// Platform that slides back and forth between its base position and base + offset
+struct PlatformMover {
+	int platform;
+	glm::vec2 basePosition, offset;
+	float period; // seconds for a full back-and-forth cycle
+};
+
+// Header of a compiled (binary) level. Every section starts at a 64 byte
+// aligned offset so the arrays can be used in place once the file is mapped.
+struct CompiledLevelHeader {
+	char magic[4];             // "LVLB"
+	uint32_t version;
+	uint32_t numOfPlatforms;
+	uint32_t numOfMovers;
+	float groundUpperline;
+	float spawnX, spawnY;
+	float leftBound, rightBound, topBound;
+	uint64_t instancesOffset;  // glm::vec4 [numOfPlatforms]
+	uint64_t leftOffset, rightOffset, lowerOffset, upperOffset; // float [numOfPlatforms]
+	uint64_t moversOffset;     // CompiledMover [numOfMovers]
+};
+
+struct CompiledMover {
+	int32_t platform;
+	float baseX, baseY, offsetX, offsetY, period;
+};
+
+const uint32_t compiledLevelVersion = 2;
+const uint64_t compiledLevelAlignment = 64;
+
+
+// Everything that makes up a level: ground, spawn point and platforms.
+// Platforms live in parallel arrays (one entry per platform) so any number of
+// them fits in a few contiguous blocks: the instance array is uploaded to the
+// GPU as is, the collider arrays are what the player tests against.
+// The arrays point either into storage owned by the level (text levels) or
+// straight into a memory-mapped compiled level (loose or inside the asset pack).
+class Level : public CollisionWorld {
+public:
+	Level() = default;
+	Level(const Level&) = delete;
+	Level& operator=(const Level&) = delete;
+
+	// Members
+	float groundUpperline = -0.8f;
+	glm::vec2 spawnPoint = glm::vec2(0.0f, -0.4f);
+	float leftBound = -1.0f, rightBound = 1.0f, topBound = 1.0f; // walls and ceiling
+
+	glm::vec4* platformsInstances = nullptr; // xy = center, zw = size
+	float* platformsLeft = nullptr;
+	float* platformsRight = nullptr;
+	float* platformsLower = nullptr;
+	float* platformsUpper = nullptr;
+	std::vector<PlatformMover> movers;
+
+	// Functions
+	bool Load(const char* path);         // text level
+	bool Parse(const std::string& source, const char* path); // text level already in memory, path only names it in errors
+	bool LoadCompiled(const char* path); // binary level, mapped without parsing
+	bool SaveCompiled(const char* path);
+	void Clear();
+	void Reserve(int count);
+
+	int NumOfPlatforms() const;
+	int AddPlatform(glm::vec2 center, glm::vec2 size);
+	void MovePlatform(int i, glm::vec2 center);
+	Collider GetCollider(int i) const;
+
+	Collider Bounds() const override;
+	int QueryColliders(glm::vec2 center, float reach, float velocityY, Collider* colliders, int maxColliders) const override;
+
+
+private:
+	// Members
+	int numOfPlatforms = 0;
+	std::vector<glm::vec4> instancesStorage;
+	std::vector<float> leftStorage, rightStorage, lowerStorage, upperStorage;
+	FileData compiledFile;
+
+	// Functions
+	void UseStorage();
+	void DetachFromFile();
+};
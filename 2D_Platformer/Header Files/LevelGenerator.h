@@ -0,0 +1,77 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <condition_variable>
+#include <GLM/glm.hpp>
+
+#include "Level.h"
+#include "PlayerPhysics.h"
+#include "ChunkSource.h"
+
+struct GeneratorSettings {
+	uint64_t seed = 1;
+	float startX = -1.0e30f; // nothing is generated left of this
+	glm::vec2 platformSize = glm::vec2(0.5f, 0.16f); // the level's default platform
+	float envelopeMargin = 0.8f; // fraction of the jump height & reach that placements use
+	int maxAttempts = 8; // placements tried per platform before leaving a gap
+	int cachedColumns = 8; // generated columns kept for the other chunks of the column
+};
+
+
+// Endless platforms, generated a chunk column at a time from a seed.
+// Each column is a random walk of platforms placed inside the jump envelope
+// (kickoff, gravity & velocityX), and every placement is checked with the
+// player's own physics: a navigation graph of the column must still reach
+// every platform from the ground, or the placement is tried again elsewhere.
+// A column only depends on the seed and its index, so columns can be generated
+// on any thread in any order, and one build always generates the same level
+// from a seed. Candidates are drawn with integer math on a 1/64 grid (the jump
+// envelope is tabulated once in Setup), but which ones are kept comes from the
+// float arc simulation. Builds only agree when they evaluate float math the
+// same way (SSE2, no fast-math, no FMA contraction); otherwise one flipped
+// placement changes the rest of its column.
+// Source() generates each column once for all of its chunks: columns are kept
+// in a small least recently used cache, and a worker asking for a column
+// another one is generating waits for it instead of generating it again.
+class LevelGenerator {
+public:
+	// Functions
+	void Setup(const Level &level, const PlayerParameters &playerParameters, float tickDelta, const GeneratorSettings &generatorSettings);
+	void Generate(int column, float left, float right, std::vector<glm::vec4> &platforms) const; // thread-safe
+	ChunkSource Source() const; // for a ChunkStreamer, valid as long as the generator (thread-safe)
+
+	float JumpHeight() const; // how high the circle's center rises
+	float JumpReach(float rise) const; // horizontal distance covered landing rise above the launch height
+
+
+private:
+	// A generated column, or one being generated (not ready)
+	struct CachedColumn {
+		int column = 0;
+		bool used = false, ready = false;
+		uint64_t lastUse = 0;
+		std::vector<glm::vec4> platforms;
+	};
+
+	// Members
+	PlayerParameters parameters;
+	GeneratorSettings settings;
+	float tickDelta;
+	float groundUpperline, topBound;
+
+	// in grid steps
+	int lowestTop, highestTop; // of a platform
+	int maxRise, minGap;
+	std::vector<int> maxGap; // [rise + maxRise], edge to edge
+
+	mutable std::mutex cacheMutex;
+	mutable std::condition_variable columnReady;
+	mutable std::vector<CachedColumn> cache;
+	mutable uint64_t useCounter = 0;
+
+	// Functions
+	void ChunkPlatforms(glm::ivec2 chunk, const Collider &region, std::vector<glm::vec4> &platforms) const;
+	bool AllReachable(const std::vector<glm::vec4> &platforms, float left, float right) const;
+};
@@ -0,0 +1,9 @@
+#pragma once
+
+// Minimal codec for the LZ4 block format (no frame header), used to compress
+// asset pack entries. Both functions return the number of bytes written, or
+// -1 if the output doesn't fit or the compressed input is malformed.
+
+int Lz4CompressBound(int inputSize);
+int Lz4Compress(const unsigned char* input, int inputSize, unsigned char* output, int outputCapacity);
+int Lz4Decompress(const unsigned char* input, int inputSize, unsigned char* output, int outputSize);
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+
+// Read-only view of a whole file mapped into memory. Pages are loaded lazily
+// by the OS, nothing is copied up front. With copyOnWrite the view may also be
+// written to: touched pages become private copies, the file is never modified.
+class MappedFile {
+public:
+	MappedFile() = default;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	~MappedFile();
+
+	// Functions
+	bool Open(const char* path, bool copyOnWrite = false);
+	void Close();
+	bool IsOpen();
+
+	unsigned char* Data();
+	size_t Size();
+
+
+private:
+	// Members
+	unsigned char* data = nullptr;
+	size_t size = 0;
+#ifdef _WIN32
+	void* fileHandle = nullptr;
+	void* mappingHandle = nullptr;
+#endif
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include "Level.h"
+#include "PlayerPhysics.h"
+#include "ThreadPool.h"
+
+enum Nav_Link_Type {NAV_WALK, NAV_JUMP, NAV_FALL};
+
+// Surface a player can stand on: node 0 is the ground, node i + 1 is the top of platform i
+struct NavNode {
+	float left, right, height;
+	uint32_t firstLink, numOfLinks; // outgoing links, contiguous in the link array
+	Collider sweep; // everything the arcs simulated from this node passed through
+};
+
+// One way to get from a node to another: stand at launchX, hold inputBits until landing
+struct NavLink {
+	int32_t from, to;
+	uint32_t type;      // Nav_Link_Type
+	uint32_t inputBits; // Input_Bits
+	float launchX, landX;
+	float time; // seconds in the air (or walking)
+};
+
+// Header of a compiled navigation graph (.navb), sections 64 byte aligned like levels
+struct CompiledNavHeader {
+	char magic[4]; // "NAVB"
+	uint32_t version;
+	uint32_t numOfNodes;
+	uint32_t numOfLinks;
+	float circleRadius, tickDelta; // the player the graph was built for
+	uint64_t nodesOffset; // NavNode [numOfNodes]
+	uint64_t linksOffset; // NavLink [numOfLinks]
+};
+
+const uint32_t compiledNavVersion = 1;
+
+// Which platform can be reached from which, found by simulating jump and fall
+// arcs with the player's own physics from points along every surface.
+// All the arc simulation happens in Build/Rebuild (or offline in the
+// AssetCompiler), so path queries only search the graph. Found paths are cached
+// per node pair; FindPath may be called from many threads at once, but not
+// while the graph is being (re)built.
+class NavGraph {
+public:
+	// Functions
+	void Build(const Level &level, const PlayerParameters &parameters, float tickDelta, ThreadPool *pool = nullptr);
+	void Rebuild(const Level &level, const Collider &changedRegion, ThreadPool *pool = nullptr); // after platforms were added or moved, pass the union of their old and new bounds (removals build it all again)
+	bool Load(const char *path, const PlayerParameters &parameters);
+	bool Save(const char *path) const;
+
+	int NodeAt(glm::vec2 position) const; // node the player is standing on, -1 when in the air
+	bool FindPath(int from, int to, std::vector<int> &path) const; // link indices, valid until the next (re)build
+
+	int NumOfNodes() const {return (int)nodes.size();}
+	const NavNode& GetNode(int i) const {return nodes[i];}
+	const NavLink& GetLink(int i) const {return links[i];}
+
+
+private:
+	// A found path (or the lack of one) between two nodes
+	struct CachedPath {
+		bool found;
+		std::vector<int> links;
+	};
+
+	// Members
+	PlayerParameters parameters;
+	float tickDelta;
+	std::vector<NavNode> nodes;
+	std::vector<NavLink> links;
+	std::vector<std::vector<NavLink>> nodeLinks; // per node, flattened into links
+
+	mutable std::mutex cacheMutex;
+	mutable std::unordered_map<uint64_t, CachedPath> pathCache;
+
+	// Functions
+	void UpdateNodes(const Level &level);
+	void SimulateNodes(const Level &level, const std::vector<int> &dirtyNodes, ThreadPool *pool);
+	void SimulateNode(const Level &level, int node);
+	bool SimulateArc(const Level &level, int node, float launchX, unsigned int inputBits, NavLink &link, Collider &sweep) const;
+	void FlattenLinks();
+	bool Search(int from, int to, std::vector<int> &path) const;
+};
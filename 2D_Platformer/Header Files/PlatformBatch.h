@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+#include <GLM/glm.hpp>
+
+#include "Level.h"
+#include "ShaderProgram.h"
+
+// Draws the platforms of a level with a single instanced call.
+// Instances (center & size) are copied from Level::platformsInstances; each Draw
+// culls them against the visible region and uploads only the ones that overlap
+// it, so a long level costs a linear scan over packed vec4s, not a draw of
+// everything.
+class PlatformBatch {
+public:
+	// Functions
+	void Setup(const ShaderSources& shaderSources);
+	void Upload(const Level& level);
+	void UpdateInstance(int i, glm::vec4 instance);
+	void Draw(glm::vec4 region, const glm::mat4& viewProjection); // region: left, bottom, right, top
+	int NumOfVisible() const {return (int)visible.size();} // of the last Draw
+	void DeleteVAO();
+
+
+private:
+	// Members
+	unsigned int vaoId, quadVBO, quadEBO, instanceVBO;
+	unsigned int capacity = 0;
+	ShaderProgram shaderProgram;
+	std::vector<glm::vec4> instances;
+	std::vector<glm::vec4> visible; // staging for the culled upload, as big as instances
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <GLM/glm.hpp>
+
+#include "Level.h"
+#include "CollisionWorld.h"
+
+
+enum Player_Movement {UP, RIGHT, LEFT};
+
+enum Input_Bits {INPUT_UP = 1, INPUT_RIGHT = 2, INPUT_LEFT = 4, INPUT_HYPER = 8,
+                 INPUT_PROBE = 16}; // synthetic latency probe (see LatencyProbe.h), no gameplay effect
+
+// Tuning of a player. Units are per second, independent of frame or tick rate
+// (the old per-frame constants 0.002 & 0.00112 behaved like this at ~2000 fps)
+struct PlayerParameters {
+	float circleRadius;
+	float velocityX = 0.5f;
+	float gravity = 4.0f;
+	float kickoff = 2.24f; // initial velocity when jumping
+	float hyperSpeedup = 0.5f;
+	float hyperTime = 2.0f;
+	float cooldownTime = 3.0f;
+
+	// range of the circle center, from the ground to the ceiling and wall to wall
+	float lowestPoint, highestPoint, leftmostPosition, rightmostPosition;
+};
+
+// Everything that changes while a player moves
+struct PlayerState {
+	glm::vec2 position;
+	float velocityY = 0.0f;
+	float timer = 0.0f;
+	float speedup = 0.0f;
+	bool tired = false;
+	bool onGround = false;
+};
+
+// The player's movement and collision rules as plain functions over a state,
+// shared by the game's Player and the batched training environment so both
+// run exactly the same physics.
+class PlayerPhysics {
+public:
+	// Functions
+	static PlayerParameters Parameters(float radius, const CollisionWorld &world);
+	static PlayerState Spawn(const Level &level);
+
+	static void ApplyInput(PlayerState &state, const PlayerParameters &parameters, unsigned int inputBits, float deltaTime);
+	static void Move(PlayerState &state, const PlayerParameters &parameters, Player_Movement key, float deltaTime);
+	static void GetHyper(PlayerState &state, const PlayerParameters &parameters);
+	static void BeNormal(PlayerState &state);
+	static void Update(PlayerState &state, const PlayerParameters &parameters, float deltaTime, const CollisionWorld &world);
+
+	static bool IsHyper(const PlayerState &state) {return state.speedup > 0.1f;}
+
+
+private:
+	// Closest point on a platform to the circle and the offset from it to the center
+	struct Contact {
+		float closestX, closestY, distanceX, distanceY;
+	};
+
+	// Functions
+	static bool DetectCollision(const PlayerState &state, const PlayerParameters &parameters, const Collider &platform, Contact &contact);
+	static void Collide(PlayerState &state, const PlayerParameters &parameters, const Collider &platform, const Contact &contact);
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+// Scoped CPU timing markers, exported as a Chrome/Perfetto trace (chrome://tracing, ui.perfetto.dev).
+// Only compiled in when PLATFORMER_PROFILE is defined (Debug configurations); otherwise
+// every macro below expands to nothing.
+//
+//   PROFILE_SCOPE("Name");          times the enclosing scope on the calling thread
+//   PROFILE_THREAD_NAME("Name");    labels the calling thread in the trace
+//   PROFILE_FRAME();                marks the start of a frame (main thread)
+//   PROFILE_WRITE_TRACE(path, n);   writes the events of the last n frames
+
+#ifdef PLATFORMER_PROFILE
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define PROFILE_USE_RDTSC
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+class Profiler {
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	// Raw timestamp in unspecified ticks (the TSC where available, a few ns to read);
+	// converted to microseconds against steady_clock when the trace is written
+	static uint64_t Now() {
+#ifdef PROFILE_USE_RDTSC
+		return __rdtsc();
+#else
+		return (uint64_t)Clock::now().time_since_epoch().count();
+#endif
+	}
+	static void Record(const char* name, uint64_t start, uint64_t end);
+	static void SetThreadName(const char* name);
+	static void MarkFrame();
+	static bool WriteTrace(const char* path, unsigned int numOfFrames);
+};
+
+// Measures its own lifetime; name must be a string literal (only the pointer is kept)
+class ProfileScope {
+public:
+	explicit ProfileScope(const char* scopeName) : name(scopeName), start(Profiler::Now()) {}
+	~ProfileScope() {Profiler::Record(name, start, Profiler::Now());}
+
+
+private:
+	const char* name;
+	uint64_t start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_THREAD_NAME(name) Profiler::SetThreadName(name)
+#define PROFILE_FRAME() Profiler::MarkFrame()
+#define PROFILE_WRITE_TRACE(path, numOfFrames) Profiler::WriteTrace(path, numOfFrames)
+
+#else
+
+#define PROFILE_SCOPE(name)
+#define PROFILE_THREAD_NAME(name)
+#define PROFILE_FRAME()
+#define PROFILE_WRITE_TRACE(path, numOfFrames) ((void)0)
+
+#endif
@@ -2,12 +2,23 @@
 
 #include <GLM/glm.hpp>
 #include <string>
+#include <vector>
+
+// Source code of a program's stages, read apart from compiling so the file
+// reads can happen on a worker thread (fragment & geometry are empty when unused).
+// Includes are already resolved, defines are injected when compiling.
+struct ShaderSources {
+	std::string vertex, fragment, geometry;
+	std::vector<std::string> feedbackVaryings; // outputs captured by transform feedback, interleaved in this order
+};
 
 class ShaderProgram {
 public:
 
 	// Public Functions 
+	static bool ReadSources(const char* vrtxPath, const char* frgmtPath, const char* gmtryPath, ShaderSources& sources); // any thread
 	void Setup(const char* vrtxPath, const char* frgmtPath, const char* gmtryPath = nullptr);
+	void Setup(const ShaderSources& sources, const std::vector<std::string>& defines = std::vector<std::string>());
 	void activate();
 	void deactivate();
 
@@ -35,4 +46,7 @@ private:
 	unsigned int shaderProgramId;
 	void checkCompileErrors(GLuint shader, std::string type);
 
+	static bool Preprocess(const std::string& path, std::string& source, int depth = 0);
+	static std::string InjectDefines(const std::string& source, const std::vector<std::string>& defines);
+
 };
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "ShaderProgram.h"
+
+// One shader compiled once per combination of its permutation flags. Flag i
+// is compiled in as `#define permutations[i]`, so variants differ at compile
+// time instead of branching on uniforms every fragment.
+class ShaderVariants {
+public:
+	// Functions
+	void Setup(const ShaderSources& shaderSources, const std::vector<std::string>& permutationNames);
+	ShaderProgram& Get(unsigned int flags); // bit i set = permutations[i] defined
+
+
+private:
+	// Members
+	std::vector<std::string> permutations;
+	std::vector<ShaderProgram> programs; // indexed by flags
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <GLM/glm.hpp>
+
+#include "Player.h"
+#include "Level.h"
+#include "CollisionWorld.h"
+#include "TripleBuffer.h"
+#include "InputQueue.h"
+
+// Instance (center & size) of a moving platform before and after the latest tick
+struct MovingPlatform {
+	int platform;
+	glm::vec4 previousInstance, instance;
+
+	glm::vec4 Instance(float alpha) const {return glm::mix(previousInstance, instance, alpha);}
+};
+
+// Immutable copy of everything the renderer needs for one frame.
+// Holds the state of the last two ticks so the renderer can blend between them.
+// Static platforms never change, so only the moving ones are copied.
+struct WorldSnapshot {
+	unsigned long long tick;
+	std::chrono::steady_clock::time_point tickTime; // when the latest tick was due
+	glm::vec2 previousPlayerPosition, playerPosition;
+	bool hyper;
+	unsigned int landings; // times the player came down on something so far
+	std::vector<MovingPlatform> movingPlatforms;
+
+	unsigned int probesApplied; // latency probes consumed so far
+	std::chrono::steady_clock::time_point probeTickTime; // when the tick that consumed the latest one ran
+
+	glm::vec2 PlayerPosition(float alpha) const {return glm::mix(previousPlayerPosition, playerPosition, alpha);}
+};
+
+// Runs the game physics at a fixed tick on its own thread, so driver stalls in
+// glfwSwapBuffers can't delay physics or input. Each tick publishes a
+// WorldSnapshot that the render thread picks up without locking.
+// Once started, the simulation owns the level; the renderer must only read it before Start().
+// The player collides with the level, or with collisionWorld when one is given (e.g. a
+// ChunkStreamer over the level).
+class Simulation {
+public:
+	// Functions
+	void Setup(Player* simPlayer, Level* simLevel, double ticksPerSecond, const CollisionWorld* collisionWorld = nullptr);
+	void Start();
+	void Stop();
+
+	void QueueInput(unsigned int inputBit, bool pressed, std::chrono::steady_clock::time_point time); // main thread
+	const WorldSnapshot& LatestSnapshot(); // render thread only
+	float InterpolationAlpha(const WorldSnapshot& snapshot); // how far the render time is between the snapshot's two ticks
+
+
+private:
+	// Members
+	Player* player;
+	Level* level;
+	const CollisionWorld* world;
+
+	float tickDelta;
+	double simulationTime = 0.0;
+	unsigned long long tickCount = 0;
+	std::chrono::steady_clock::time_point tickTime;
+
+	// state before the latest tick, for interpolation
+	glm::vec2 previousPlayerPosition;
+	std::vector<glm::vec4> previousMoversInstances;
+
+	std::thread thread;
+	std::atomic<bool> running {false};
+	InputQueue inputQueue;
+	unsigned int heldInput = 0; // keys down as of the latest tick
+	unsigned int landings = 0;
+	unsigned int probesApplied = 0;
+	std::chrono::steady_clock::time_point probeTickTime;
+	TripleBuffer<WorldSnapshot> snapshots;
+
+	// Functions
+	void Run();
+	void Tick();
+	unsigned int ConsumeInput();
+	void MovePlatforms();
+	void Publish();
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <GLM/glm.hpp>
+
+// Offscreen cache for geometry that doesn't move (ground, platforms).
+// The layer is rendered once into a texture and composited every frame with a
+// single blit; it is only re-rendered after Invalidate(), a framebuffer resize,
+// or when the view leaves the region the cache was rendered for.
+// The cached region reaches a quarter view past every edge of the view, so a
+// scrolling camera only re-renders it every so often; in between the blit just
+// reads from an offset (the view must be snapped to whole pixels, see Camera).
+class StaticLayer {
+public:
+	// Functions
+	void Setup(int width, int height);
+	void Update(int width, int height, glm::vec4 viewRegion);
+	void Invalidate();
+	bool IsDirty();
+	glm::vec4 CachedRegion() const {return cachedRegion;} // what to render between Begin & EndCapture
+
+	void BeginCapture();
+	void EndCapture();
+	void Composite(glm::vec4 viewRegion);
+	void Delete();
+
+
+private:
+	// Members
+	unsigned int framebufferId, colorTextureId;
+	int viewWidth, viewHeight;   // framebuffer size
+	int layerWidth, layerHeight; // view plus margins
+	bool dirty = true;
+	glm::vec4 cachedRegion; // left, bottom, right, top of the area held in the texture
+
+	// Functions
+	void AllocateStorage();
+};
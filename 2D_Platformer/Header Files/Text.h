@@ -1,38 +1,39 @@
 #pragma once
 
 #include <map>
+#include <vector>
 #include <iostream>
 
 #include <GLFW/glfw3.h>
 #include <GLM/glm.hpp>
-#include <ft2build.h>
-#include FT_FREETYPE_H
 
 #include "ShaderProgram.h"
+#include "FontAtlas.h"
 
 struct Character {
-	GLuint     textureId;  // ID handle of the glyph texture
-	glm::ivec2 Size;       // Size of glyph
-	glm::ivec2 Bearing;    // Offset from baseline to left/top of glyph
-	GLuint     Advance;    // Offset to advance to next glyph
+	glm::vec4  atlasRegion; // texture coordinates of the glyph in the atlas (left, top, right, bottom)
+	glm::ivec2 Size;        // Size of glyph
+	glm::ivec2 Bearing;     // Offset from baseline to left/top of glyph
+	GLuint     Advance;     // Offset to advance to next glyph
+	bool       present = false;
 };
 
+// Draws text from a baked font atlas (see FontAtlas.h), one draw call per string
 class Text {
 public:
-	// Constructor
-	Text(unsigned int width, unsigned int height, const char* vrtxShaderPath, const char* frgmtShaderPath, unsigned int SCR_WIDTH, unsigned int SCR_HEIGHT);
-	
 	// Functions
-	void RenderText(std::string text, GLfloat x, GLfloat y, GLfloat scale, glm::vec3 color);
+	void Setup(const ShaderSources& shaderSources, unsigned int SCR_WIDTH, unsigned int SCR_HEIGHT);
+	void UploadAtlas(const FontAtlas& atlas);
+	void RenderText(const char* text, GLfloat x, GLfloat y, GLfloat scale, glm::vec3 color);
+	void Delete();
 
 
 private:
 	// Members
-	unsigned int vaoId, vboId;
+	unsigned int vaoId, vboId, atlasTextureId = 0;
+	unsigned int vertexCapacity = 0;
 	ShaderProgram shaderProgramId;
-	std::map<GLchar, Character> CharactersMap;
-
-	// Functions
-	void AddToMap(FT_Face face, GLuint textureId, char c);
-	void GenerateCharTexture(FT_Face face, GLuint &textureId);
-};
\ No newline at end of file
+	Character characters[128];
+	std::map<std::pair<GLchar, GLchar>, int> kerning; // extra advance between two characters, 1/64 pixels
+	std::vector<GLfloat> vertices;
+};
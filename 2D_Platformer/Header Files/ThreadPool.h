@@ -0,0 +1,33 @@
+#pragma once
+
+#include <mutex>
+#include <deque>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+// Fixed set of worker threads pulling tasks from one queue.
+// Tasks must not touch OpenGL, the context belongs to the main thread.
+class ThreadPool {
+public:
+	// Functions
+	void Setup(unsigned int numOfThreads = 0); // 0 = one per core, leaving one for the main thread
+	void Submit(std::function<void()> task);
+	// Runs body(begin, end) over [0, count) in chunks on the workers and the calling thread, returns once all are done
+	void ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)> &body);
+	void Shutdown(); // finishes queued tasks, then joins the workers
+	unsigned int NumOfThreads() const {return (unsigned int)workers.size();}
+
+
+private:
+	// Members
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()>> tasks;
+	std::mutex mutex;
+	std::condition_variable wakeUp;
+	bool stopping = false;
+
+	// Functions
+	void Work();
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <GLM/glm.hpp>
+
+#include "CollisionWorld.h"
+
+enum Tile_Type {TILE_EMPTY, TILE_SOLID, TILE_ONE_WAY};
+
+const int tileChunkSize = 32; // cells per chunk side
+
+// 32 x 32 cells, 2 bits each: cell (x, y) of the chunk is bits 2x..2x+1 of rows[y]
+struct TileChunk {
+	uint64_t rows[tileChunkSize];
+};
+
+// Header of a compiled tile map (.tmap), the chunks follow 64 byte aligned
+struct CompiledTileMapHeader {
+	char magic[4]; // "TMAP"
+	uint32_t version;
+	uint32_t width, height; // in cells
+	float cellSize;
+	float originX, originY;
+	float spawnX, spawnY;
+	uint32_t reserved;
+	uint64_t chunksOffset; // TileChunk [chunksX * chunksY], rows of chunks from the bottom
+};
+
+const uint32_t compiledTileMapVersion = 1;
+
+
+// A world made of a grid of solid, one-way and empty cells, for levels too big
+// to list as free rectangles. Cells are bit packed in 32 x 32 chunks so finding
+// a cell is a couple of shifts, and a player only looks at the few cells around
+// it instead of every collider in the world.
+// Cell (0, 0) is the bottom left one, at origin.
+class TileMap : public CollisionWorld {
+public:
+	// Members
+	glm::vec2 origin = glm::vec2(-1.0f, -1.0f); // bottom left corner of the map
+	float cellSize = 0.05f;
+	glm::vec2 spawnPoint = glm::vec2(0.0f, 0.0f);
+
+	// Functions
+	bool Load(const char* path);         // text tile map
+	bool LoadCompiled(const char* path); // binary tile map
+	bool SaveCompiled(const char* path) const;
+	void Resize(int widthInCells, int heightInCells); // clears every cell
+
+	int Width() const {return width;}
+	int Height() const {return height;}
+	Tile_Type GetCell(int x, int y) const;
+	void SetCell(int x, int y, Tile_Type type);
+	glm::ivec2 CellAt(glm::vec2 position) const; // may be outside the map
+	Collider CellBounds(int x, int y) const;
+
+	Collider Bounds() const override;
+	int QueryColliders(glm::vec2 center, float reach, float velocityY, Collider* colliders, int maxColliders) const override;
+
+
+private:
+	// Members
+	int width = 0, height = 0;
+	int chunksX = 0, chunksY = 0;
+	std::vector<TileChunk> chunks;
+
+	// Functions
+	uint32_t RowBits(int chunkX, int y, Tile_Type type) const;
+	int NextCell(int y, int from, int to, Tile_Type type, bool isType) const;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <GLM/glm.hpp>
+
+#include "TileMap.h"
+#include "ShaderProgram.h"
+
+// Draws a TileMap a chunk at a time, never a call per tile.
+// Each 32 x 32 chunk's cells are baked into one static vertex & index buffer,
+// as quads merged along rows, when it loads (Bake, or BakeRegion ahead of a
+// camera cut); after that it is only rebaked once marked dirty by an edit.
+// Draw bakes what is still dirty in view itself, so nothing is ever missing,
+// but that stalls the frame it happens in. Each Draw works out the range of
+// chunks under the visible region from its corners, so whole chunks are culled
+// without looking at them, and a screen of tiles costs one draw per chunk it
+// touches (at most 9 with the default cell size & camera view).
+class TileMapRenderer {
+public:
+	// Functions
+	void Setup(const ShaderSources& shaderSources);
+	void Upload(const TileMap& tileMap); // the map has to outlive the renderer, baked chunks are dropped
+	void MarkDirty(int cellX, int cellY); // after TileMap::SetCell on that cell
+	void Bake(int chunkX, int chunkY); // when the chunk loads, only if it is dirty
+	void BakeRegion(glm::vec4 region); // every chunk Draw would draw for region
+	void Draw(glm::vec4 region, const glm::mat4& viewProjection); // region: left, bottom, right, top
+	int NumOfDrawn() const {return drawn;} // chunks, of the last Draw
+	void DeleteVAO();
+
+
+private:
+	struct TileVertex {
+		glm::vec2 position;
+		float type; // Tile_Type
+	};
+
+	// One chunk's baked cells, GL objects are created on its first bake
+	struct ChunkMesh {
+		unsigned int vaoId = 0, vbo = 0, ebo = 0;
+		int indexCount = 0;
+		bool dirty = true;
+	};
+
+	// Members
+	const TileMap* tileMap = nullptr;
+	int chunksX = 0, chunksY = 0;
+	std::vector<ChunkMesh> meshes; // rows of chunks from the bottom, like the map's
+	std::vector<TileVertex> vertices; // bake staging, reused
+	std::vector<uint16_t> indices;
+	ShaderProgram shaderProgram;
+	int drawn = 0;
+
+	// Functions
+	bool ChunkRange(glm::vec4 region, glm::ivec2& lowest, glm::ivec2& highest) const; // false when it misses the map
+	void BakeMesh(int chunkX, int chunkY, ChunkMesh& mesh);
+	void DeleteMeshes();
+};
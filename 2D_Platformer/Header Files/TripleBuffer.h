@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+
+// Lock-free single-producer/single-consumer triple buffer.
+// The writer fills WriteBuffer() and calls Publish(); the reader calls Read()
+// and always gets the most recently published value. Neither side ever waits
+// for the other: they only swap slot indices with one atomic exchange.
+template <typename T>
+class TripleBuffer {
+public:
+	// Fill every slot with the same value, must be called before the reader starts
+	void Reset(const T& value) {
+		for (int i = 0; i < 3; i++) slots[i] = value;
+		frontIndex = 0;
+		middleState.store(1, std::memory_order_relaxed);
+		backIndex = 2;
+	}
+
+	// Writer side
+	T& WriteBuffer() {return slots[backIndex];}
+	void Publish() {backIndex = middleState.exchange(backIndex | freshBit, std::memory_order_acq_rel) & indexMask;}
+
+	// Reader side, returns the latest published value
+	const T& Read() {
+		if (middleState.load(std::memory_order_relaxed) & freshBit)
+			frontIndex = middleState.exchange(frontIndex, std::memory_order_acq_rel) & indexMask;
+		return slots[frontIndex];
+	}
+
+
+private:
+	static const int freshBit = 4;  // set when the middle slot holds a value the reader hasn't seen
+	static const int indexMask = 3;
+
+	T slots[3];
+	int frontIndex = 0;                  // owned by the reader
+	std::atomic<int> middleState {1};    // shared
+	int backIndex = 2;                   // owned by the writer
+};
@@ -1,8 +1,21 @@
 #version 330 core
+in vec2 localPosition;
 out vec4 fragmentColor;
 
-uniform bool hyper = false;
+// permutation: HYPER (darker while hyper)
+#ifdef HYPER
+const vec3 circleColor = vec3(0.5, 0.0, 0.0);
+#else
+const vec3 circleColor = vec3(1.0, 0.0, 0.0);
+#endif
 
 void main() {
-    fragmentColor = vec4((hyper ? 0.5f : 1.0f), 0.0f, 0.0f, 1.0f);
+    // signed distance to the circle's edge (negative inside), in local units
+    float signedDistance = length(localPosition) - 1.0;
+
+    // fade over one pixel around the edge for analytic anti-aliasing
+    float coverage = clamp(0.5 - signedDistance / fwidth(signedDistance), 0.0, 1.0);
+    if (coverage == 0.0) discard;
+
+    fragmentColor = vec4(circleColor, coverage);
 }
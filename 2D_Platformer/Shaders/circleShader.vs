@@ -1,8 +1,10 @@
 #version 330 core
-layout (location = 0) in vec3 positionAttribute;
+#include "common/instancedQuad.glsl"
+layout (location = 1) in vec3 instanceAttribute; // xy = center, z = radius
 
-uniform mat4 modelMat;
+out vec2 localPosition;
 
 void main() {
-    gl_Position = modelMat * vec4(positionAttribute, 1.0);
+    localPosition = cornerAttribute; // quad corner around the unit circle
+    gl_Position = QuadPosition(instanceAttribute.xy, instanceAttribute.zz);
 }
@@ -0,0 +1,9 @@
+// Shared vertex stage of the instanced quad batches: a unit quad corner
+// (per vertex) placed in the world by an instance's center & size (per instance)
+layout (location = 0) in vec2 cornerAttribute;
+
+uniform mat4 viewProjection; // camera, world units to clip space
+
+vec4 QuadPosition(vec2 center, vec2 size) {
+    return viewProjection * vec4(center + cornerAttribute * size, 0.0, 1.0);
+}
@@ -0,0 +1,14 @@
+#version 330 core
+#include "common/instancedQuad.glsl"
+layout (location = 1) in vec4 motionAttribute; // xy = position, zw = velocity
+layout (location = 2) in vec4 lifeAttribute;   // x = seconds left, y = 1 / lifetime, z = size
+
+out vec2 localPosition;
+out float lifeLeft;
+
+void main() {
+    localPosition = 2.0 * cornerAttribute; // -1..1 across the quad
+    lifeLeft = max(lifeAttribute.x * lifeAttribute.y, 0.0);
+    float size = lifeAttribute.x > 0.0 ? lifeAttribute.z : 0.0; // dead ones collapse to a point, no fragments
+    gl_Position = QuadPosition(motionAttribute.xy, vec2(size));
+}
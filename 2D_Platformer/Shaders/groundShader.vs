@@ -1,6 +1,8 @@
 #version 330 core
 layout (location = 0) in vec3 positionAttribute;
 
+uniform mat4 viewProjection; // camera, world units to clip space
+
 void main() {
-    gl_Position = vec4(positionAttribute, 1.0);
+    gl_Position = viewProjection * vec4(positionAttribute, 1.0);
 }
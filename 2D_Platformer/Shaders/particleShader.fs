@@ -0,0 +1,14 @@
+#version 330 core
+in vec2 localPosition;
+in float lifeLeft;
+out vec4 fragmentColor;
+
+uniform vec4 particleColor; // per material
+
+void main() {
+    // soft round speck, fading out as it dies
+    float falloff = 1.0 - dot(localPosition, localPosition);
+    if (falloff <= 0.0) discard;
+
+    fragmentColor = vec4(particleColor.rgb, particleColor.a * falloff * lifeLeft);
+}
@@ -0,0 +1,12 @@
+#version 330 core
+#include "common/instancedQuad.glsl"
+layout (location = 1) in vec4 instanceAttribute; // xy = center, z = size, w = life left (1 -> 0)
+
+out vec2 localPosition;
+out float lifeLeft;
+
+void main() {
+    localPosition = 2.0 * cornerAttribute; // -1..1 across the quad
+    lifeLeft = instanceAttribute.w;
+    gl_Position = QuadPosition(instanceAttribute.xy, instanceAttribute.zz);
+}
@@ -0,0 +1,56 @@
+#version 330 core
+// Transform feedback pass of GpuParticleSystem: one vertex per particle, the
+// outputs are its next state (nothing is rasterized)
+layout (location = 0) in vec4 motionAttribute; // xy = position, zw = velocity
+layout (location = 1) in vec4 lifeAttribute;   // x = seconds left, y = 1 / lifetime, z = size
+
+out vec4 motion;
+out vec4 life;
+
+uniform float deltaTime;
+uniform float damping; // velocity kept this step
+uniform float fall;    // gravity this step
+
+// Slots [spawnStart, spawnStart + spawnCount) of the ring restart at the emitter
+uniform int capacity;
+uniform int spawnStart;
+uniform int spawnCount;
+uniform int frameSeed;
+uniform vec2 emitterPosition;
+uniform vec2 minVelocity;
+uniform vec2 maxVelocity;
+uniform vec2 lifeRange;
+uniform vec2 sizeRange;
+
+// PCG hash, one step per random number
+uint Hash(uint value) {
+    uint state = value * 747796405u + 2891336453u;
+    uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+float Random(inout uint state, float low, float high) {
+    state = Hash(state);
+    return mix(low, high, float(state >> 8u) * (1.0 / 16777216.0));
+}
+
+void main() {
+    int slot = gl_VertexID - spawnStart;
+    if (slot < 0) slot += capacity;
+
+    if (slot < spawnCount) {
+        uint state = Hash(uint(gl_VertexID) ^ Hash(uint(frameSeed)));
+        vec2 velocity = vec2(Random(state, minVelocity.x, maxVelocity.x), Random(state, minVelocity.y, maxVelocity.y));
+        float lifetime = Random(state, lifeRange.x, lifeRange.y);
+        motion = vec4(emitterPosition, velocity);
+        life = vec4(lifetime, 1.0 / lifetime, Random(state, sizeRange.x, sizeRange.y), 0.0);
+    } else if (lifeAttribute.x > 0.0) {
+        // same steps as ParticleSystem's CPU integrate
+        vec2 velocity = motionAttribute.zw * damping - vec2(0.0, fall);
+        motion = vec4(motionAttribute.xy + velocity * deltaTime, velocity);
+        life = vec4(lifeAttribute.x - deltaTime, lifeAttribute.yzw);
+    } else {
+        motion = motionAttribute;
+        life = lifeAttribute;
+    }
+}
@@ -1,8 +1,7 @@
 #version 330 core
-layout (location = 0) in vec3 positionAttribute;
-
-uniform mat4 modelMat;
+#include "common/instancedQuad.glsl"
+layout (location = 1) in vec4 instanceAttribute; // xy = center, zw = size
 
 void main() {
-    gl_Position = modelMat * vec4(positionAttribute, 1.0);
+    gl_Position = QuadPosition(instanceAttribute.xy, instanceAttribute.zw);
 }
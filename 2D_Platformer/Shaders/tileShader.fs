@@ -0,0 +1,9 @@
+#version 330 core
+flat in int tileType; // Tile_Type, TILE_ONE_WAY is defined by TileMapRenderer
+
+out vec4 fragmentColor;
+
+void main() {
+    // solid cells like platforms, one-way ones lighter
+    fragmentColor = tileType == TILE_ONE_WAY ? vec4(0.4f, 0.6f, 1.0f, 1.0f) : vec4(0.0f, 0.0f, 1.0f, 1.0f);
+}
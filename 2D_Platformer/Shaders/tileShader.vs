@@ -0,0 +1,12 @@
+#version 330 core
+layout (location = 0) in vec2 positionAttribute; // world units
+layout (location = 1) in float typeAttribute;    // Tile_Type
+
+flat out int tileType;
+
+uniform mat4 viewProjection; // camera, world units to clip space
+
+void main() {
+    tileType = int(typeAttribute);
+    gl_Position = viewProjection * vec4(positionAttribute, 0.0, 1.0);
+}
@@ -0,0 +1,38 @@
+#include <new>
+#include <cstdlib>
+#include <cstdint>
+
+#include "AllocationCounter.h"
+
+#ifdef PLATFORMER_COUNT_ALLOCATIONS
+
+// Thread-local so worker threads loading assets don't show up in the frame's count
+static thread_local uint64_t threadAllocations = 0;
+
+static void* CountedAllocate(size_t size) {
+	threadAllocations++;
+	void* memory = std::malloc(size == 0 ? 1 : size);
+	if (memory == nullptr) throw std::bad_alloc();
+	return memory;
+}
+
+void* operator new(size_t size) {return CountedAllocate(size);}
+void* operator new[](size_t size) {return CountedAllocate(size);}
+void* operator new(size_t size, const std::nothrow_t&) noexcept {threadAllocations++; return std::malloc(size == 0 ? 1 : size);}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {threadAllocations++; return std::malloc(size == 0 ? 1 : size);}
+void operator delete(void* memory) noexcept {std::free(memory);}
+void operator delete[](void* memory) noexcept {std::free(memory);}
+void operator delete(void* memory, size_t) noexcept {std::free(memory);}
+void operator delete[](void* memory, size_t) noexcept {std::free(memory);}
+void operator delete(void* memory, const std::nothrow_t&) noexcept {std::free(memory);}
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {std::free(memory);}
+
+bool AllocationCounter::Enabled() {return true;}
+uint64_t AllocationCounter::ThreadAllocations() {return threadAllocations;}
+
+#else
+
+bool AllocationCounter::Enabled() {return false;}
+uint64_t AllocationCounter::ThreadAllocations() {return 0;}
+
+#endif
@@ -0,0 +1,106 @@
+#include <mutex>
+#include <chrono>
+#include <exception>
+#include <iostream>
+
+#include "AssetLoader.h"
+#include "Profiler.h"
+
+
+// Runs one stage of an asset; a stage that throws fails with the exception's
+// message instead of unwinding out of the worker (or the frame) and leaving
+// the asset unfinished forever
+static bool RunGuarded(const std::function<bool()> &stage, std::string &error) {
+	try {
+		return stage();
+	} catch (const std::exception& exception) {
+		error = exception.what();
+	} catch (...) {
+		error = "unknown exception";
+	}
+	return false;
+}
+
+// Public Functions:
+
+void AssetLoader::Setup(ThreadPool* workerPool, double uploadBudgetMs) {
+	pool = workerPool;
+	uploadBudget = uploadBudgetMs / 1000.0;
+}
+
+void AssetLoader::Load(const char* name, std::function<bool(AssetUploads&)> work) {
+	std::shared_ptr<Asset> asset = std::make_shared<Asset>();
+	asset->name = name;
+	assets.push_back(asset);
+
+	pool->Submit([this, asset, work] {
+		asset->failed = !RunGuarded([&] {return work(asset->uploads);}, asset->error);
+		asset->numOfUploads = asset->uploads.uploads.size();
+		asset->read = true; // publishes the fields above to the main thread
+
+		std::lock_guard<std::mutex> lock(readyMutex);
+		readyToUpload.push_back(asset);
+	});
+}
+
+void AssetLoader::Update() {
+	PROFILE_SCOPE("AssetLoader::Update");
+	typedef std::chrono::steady_clock Clock;
+	Clock::time_point start = Clock::now();
+
+	// Run staged uploads until the budget is spent, but always make some progress
+	while (true) {
+		std::shared_ptr<Asset> asset;
+		{
+			std::lock_guard<std::mutex> lock(readyMutex);
+			if (readyToUpload.empty()) return;
+			asset = readyToUpload.front();
+		}
+
+		if (asset->failed) {
+			std::cout << "ERROR::ASSET_LOADER::FAILED_TO_LOAD: " << asset->name;
+			if (!asset->error.empty()) std::cout << " (" << asset->error << ")";
+			std::cout << std::endl;
+			anyFailed = true;
+			asset->uploads.uploads.clear();
+			asset->uploadsDone = asset->numOfUploads;
+		} else if (!asset->uploads.uploads.empty()) {
+			std::function<void()>& upload = asset->uploads.uploads.front();
+			if (!RunGuarded([&] {upload(); return true;}, asset->error)) {
+				asset->failed = true; // reported & dropped on the next pass
+				continue;
+			}
+			asset->uploads.uploads.pop_front();
+			asset->uploadsDone++;
+		}
+
+		if (asset->uploads.uploads.empty()) {
+			std::lock_guard<std::mutex> lock(readyMutex);
+			readyToUpload.pop_front();
+			numOfFinished++;
+		}
+
+		if (std::chrono::duration<double>(Clock::now() - start).count() >= uploadBudget) return;
+	}
+}
+
+// Half of each asset's weight is its worker stage, half its uploads
+float AssetLoader::Progress() const {
+	if (assets.empty()) return 1.0f;
+
+	float progress = 0.0f;
+	for (const std::shared_ptr<Asset>& asset : assets) {
+		if (!asset->read) continue;
+		progress += 0.5f;
+		progress += asset->numOfUploads == 0 ? 0.5f : 0.5f * asset->uploadsDone / asset->numOfUploads;
+	}
+	return progress / assets.size();
+}
+
+bool AssetLoader::IsDone() const {
+	return numOfFinished == assets.size();
+}
+
+bool AssetLoader::Failed() const {
+	return anyFailed;
+}
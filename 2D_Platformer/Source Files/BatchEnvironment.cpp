@@ -0,0 +1,168 @@
+#include <cfloat>
+#include <iostream>
+#include <vector>
+
+#include <GLM/glm.hpp>
+
+#include "BatchEnvironment.h"
+#include "PlayerPhysics.h"
+#include "Level.h"
+#include "ThreadPool.h"
+#include "Profiler.h"
+
+
+// Instances handed to a worker at a time, enough to hide the task overhead
+static const size_t instancesPerChunk = 1024;
+
+
+// Public Functions:
+
+bool BatchEnvironment::Setup(const Level * envLevel, ThreadPool * workerPool, int instances, float radius, double ticksPerSecond, unsigned int maxTicks) {
+	if (instances <= 0 || ticksPerSecond <= 0.0 || maxTicks == 0) {
+		std::cout << "ERROR::BATCH_ENVIRONMENT::BAD_SETTINGS" << std::endl;
+		return false;
+	}
+
+	level = envLevel;
+	pool = workerPool;
+	parameters = PlayerPhysics::Parameters(radius, *level);
+	spawnState = PlayerPhysics::Spawn(*level);
+	tickDelta = (float)(1.0 / ticksPerSecond);
+	maxEpisodeTicks = maxTicks;
+	numOfInstances = instances;
+
+	positionX.resize(instances);
+	positionY.resize(instances);
+	velocityY.resize(instances);
+	timer.resize(instances);
+	speedup.resize(instances);
+	tired.resize(instances);
+	onGround.resize(instances);
+	bestHeight.resize(instances);
+	episodeTicks.resize(instances);
+
+	numOfPlatforms = level->NumOfPlatforms();
+	size_t numOfChunks = (instances + instancesPerChunk - 1) / instancesPerChunk;
+	distanceScratch.resize(numOfChunks * numOfPlatforms);
+	return true;
+}
+
+void BatchEnvironment::Reset(float * observations) {
+	PROFILE_SCOPE("BatchEnvironment::Reset");
+	pool->ParallelFor(numOfInstances, instancesPerChunk, [this, observations](size_t begin, size_t end) {
+		float* distances = ChunkScratch(begin);
+		for (size_t i = begin; i < end; i++) {
+			ResetInstance(i);
+			Observe(i, observations + i * observationSize, distances);
+		}
+	});
+}
+
+void BatchEnvironment::Step(const unsigned int * actions, float * observations, float * rewards, unsigned char * dones) {
+	PROFILE_SCOPE("BatchEnvironment::Step");
+	pool->ParallelFor(numOfInstances, instancesPerChunk, [this, actions, observations, rewards, dones](size_t begin, size_t end) {
+		StepRange(begin, end, actions, observations, rewards, dones);
+	});
+}
+
+
+
+
+// Private Functions:
+
+// Same order as Simulation::Tick: input, then physics
+void BatchEnvironment::StepRange(size_t begin, size_t end, const unsigned int * actions, float * observations, float * rewards, unsigned char * dones) {
+	const unsigned int gameplayBits = INPUT_UP | INPUT_RIGHT | INPUT_LEFT | INPUT_HYPER;
+	float* distances = ChunkScratch(begin);
+
+	for (size_t i = begin; i < end; i++) {
+		PlayerState state = LoadState(i);
+		PlayerPhysics::ApplyInput(state, parameters, actions[i] & gameplayBits, tickDelta);
+		PlayerPhysics::Update(state, parameters, tickDelta, *level);
+		StoreState(i, state);
+
+		rewards[i] = glm::max(0.0f, state.position.y - bestHeight[i]);
+		bestHeight[i] = glm::max(bestHeight[i], state.position.y);
+
+		episodeTicks[i]++;
+		bool done = episodeTicks[i] >= maxEpisodeTicks || state.position.y == parameters.highestPoint;
+		dones[i] = done ? 1 : 0;
+		if (done) ResetInstance(i);
+
+		Observe(i, observations + i * observationSize, distances);
+	}
+}
+
+// ParallelFor hands out chunks starting at multiples of instancesPerChunk
+float* BatchEnvironment::ChunkScratch(size_t begin) {
+	return distanceScratch.data() + begin / instancesPerChunk * numOfPlatforms;
+}
+
+void BatchEnvironment::ResetInstance(size_t i) {
+	StoreState(i, spawnState);
+	bestHeight[i] = spawnState.position.y;
+	episodeTicks[i] = 0;
+}
+
+PlayerState BatchEnvironment::LoadState(size_t i) const {
+	PlayerState state;
+	state.position = glm::vec2(positionX[i], positionY[i]);
+	state.velocityY = velocityY[i];
+	state.timer = timer[i];
+	state.speedup = speedup[i];
+	state.tired = tired[i] != 0;
+	state.onGround = onGround[i] != 0;
+	return state;
+}
+
+void BatchEnvironment::StoreState(size_t i, const PlayerState & state) {
+	positionX[i] = state.position.x;
+	positionY[i] = state.position.y;
+	velocityY[i] = state.velocityY;
+	timer[i] = state.timer;
+	speedup[i] = state.speedup;
+	tired[i] = state.tired ? 1 : 0;
+	onGround[i] = state.onGround ? 1 : 0;
+}
+
+void BatchEnvironment::Observe(size_t i, float * observation, float * distance) const {
+	float x = positionX[i], y = positionY[i];
+	observation[OBS_POSITION_X] = x;
+	observation[OBS_POSITION_Y] = y;
+	observation[OBS_VELOCITY_Y] = velocityY[i];
+	observation[OBS_ON_GROUND] = onGround[i] ? 1.0f : 0.0f;
+	observation[OBS_HYPER] = speedup[i] > 0.1f ? 1.0f : 0.0f;
+	observation[OBS_TIRED] = tired[i] ? 1.0f : 0.0f;
+	observation[OBS_TIMER] = timer[i];
+
+	// squared distance from the player to the closest point of every platform;
+	// branch free over the collider arrays so the compiler can vectorize it
+	const float *left = level->platformsLeft, *right = level->platformsRight;
+	const float *lower = level->platformsLower, *upper = level->platformsUpper;
+	for (int p = 0; p < numOfPlatforms; p++) {
+		float distanceX = x - glm::max(left[p], glm::min(x, right[p]));
+		float distanceY = y - glm::max(lower[p], glm::min(y, upper[p]));
+		distance[p] = distanceX * distanceX + distanceY * distanceY;
+	}
+
+	// pick the nearest few, missing ones are left as zeros
+	float *platforms = observation + OBS_PLATFORMS;
+	for (int k = 0; k < numOfNearbyPlatforms; k++) {
+		int nearest = -1;
+		float nearestDistance = FLT_MAX;
+		for (int p = 0; p < numOfPlatforms; p++) {
+			if (distance[p] < nearestDistance) nearest = p, nearestDistance = distance[p];
+		}
+
+		float *bounds = platforms + 4 * k;
+		if (nearest < 0) {
+			bounds[0] = bounds[1] = bounds[2] = bounds[3] = 0.0f;
+			continue;
+		}
+		bounds[0] = left[nearest] - x;
+		bounds[1] = right[nearest] - x;
+		bounds[2] = lower[nearest] - y;
+		bounds[3] = upper[nearest] - y;
+		distance[nearest] = FLT_MAX;
+	}
+}
@@ -0,0 +1,77 @@
+#include <GLM/glm.hpp>
+#include <GLM/gtc/matrix_transform.hpp>
+
+#include "Camera.h"
+#include "CollisionWorld.h"
+
+
+// Public Functions:
+
+void Camera::Setup(glm::vec2 size, int framebufferWidth, int framebufferHeight) {
+	viewSize = size;
+	Resize(framebufferWidth, framebufferHeight);
+}
+
+void Camera::Resize(int framebufferWidth, int framebufferHeight) {
+	if (framebufferWidth == 0 || framebufferHeight == 0) return; // minimized
+	pixelSize = viewSize / glm::vec2((float)framebufferWidth, (float)framebufferHeight);
+	Constrain();
+}
+
+void Camera::SetBounds(const Collider & worldBounds) {
+	bounds = worldBounds;
+	Constrain();
+}
+
+void Camera::SetPosition(glm::vec2 center) {
+	position = center;
+	Constrain();
+}
+
+void Camera::Follow(glm::vec2 target, float deltaTime) {
+	// how far the target is outside the dead zone on each axis
+	glm::vec2 offset = target - position;
+	glm::vec2 outside = offset - glm::clamp(offset, -deadZone, deadZone);
+
+	// ease towards it, frame rate independent
+	float blend = 1.0f - glm::exp(-followSpeed * deltaTime);
+	position += outside * blend;
+	Constrain();
+}
+
+
+// Around the position rounded to whole pixels; the position itself stays exact
+// so slow camera motion isn't lost to rounding
+glm::vec4 Camera::ViewRegion() const {
+	glm::vec2 half = 0.5f * viewSize;
+	glm::vec2 center = glm::floor(position / pixelSize + 0.5f) * pixelSize;
+	return glm::vec4(center - half, center + half);
+}
+
+glm::mat4 Camera::ViewProjection() const {return ViewProjection(ViewRegion());}
+
+bool Camera::IsVisible(const Collider & box) const {return Overlaps(ViewRegion(), box);}
+
+
+glm::mat4 Camera::ViewProjection(glm::vec4 region) {
+	return glm::ortho(region.x, region.z, region.y, region.w);
+}
+
+bool Camera::Overlaps(glm::vec4 region, const Collider & box) {
+	return box.rightSide >= region.x && box.leftSide <= region.z && box.upperSide >= region.y && box.lowerSide <= region.w;
+}
+
+
+
+// Private Functions:
+
+// Keeps the view inside the bounds, centered on an axis where the bounds are smaller than the view
+void Camera::Constrain() {
+	glm::vec2 half = 0.5f * viewSize;
+	glm::vec2 lowest = glm::vec2(bounds.leftSide, bounds.lowerSide) + half;
+	glm::vec2 highest = glm::vec2(bounds.rightSide, bounds.upperSide) - half;
+	for (int axis = 0; axis < 2; axis++) {
+		if (lowest[axis] > highest[axis]) position[axis] = 0.5f * (lowest[axis] + highest[axis]);
+		else position[axis] = glm::clamp(position[axis], lowest[axis], highest[axis]);
+	}
+}
@@ -0,0 +1,302 @@
+#include <mutex>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <GLAD/glad.h>
+#include <GLM/glm.hpp>
+
+#include "ChunkStreamer.h"
+#include "ShaderProgram.h"
+#include "FileSystem.h"
+#include "Level.h"
+#include "Profiler.h"
+
+
+// Unit quad, scaled & moved per instance in the vertex shader (as in PlatformBatch)
+static const float quadCorners[4 * 2] = {
+	-0.5f, -0.5f, // lower left
+	 0.5f, -0.5f, // lower right
+	 0.5f,  0.5f, // upper right
+	-0.5f,  0.5f  // upper left
+};
+static const unsigned int quadIndices[6] = {0, 1, 3, 1, 2, 3};
+
+static bool Overlaps(const Collider &a, const Collider &b) {
+	return a.rightSide >= b.leftSide && a.leftSide <= b.rightSide && a.upperSide >= b.lowerSide && a.lowerSide <= b.upperSide;
+}
+
+
+// Public Functions:
+
+void ChunkStreamer::Setup(const ShaderSources & shaderSources, const ChunkStreamingSettings & streamingSettings) {
+	settings = streamingSettings;
+	shaderProgram.Setup(shaderSources);
+
+	// Shared quad (per vertex)
+	glGenBuffers(1, &quadVBO);
+	glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(quadCorners), quadCorners, GL_STATIC_DRAW);
+	glGenBuffers(1, &quadEBO);
+
+	// Every slot draws its own instance buffer with the shared quad
+	slots.resize(settings.maxChunks);
+	for (ChunkSlot& slot : slots) {
+		glGenVertexArrays(1, &slot.vaoId);
+		glBindVertexArray(slot.vaoId);
+
+		glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+		glEnableVertexAttribArray(0);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadEBO);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(quadIndices), quadIndices, GL_STATIC_DRAW);
+
+		glGenBuffers(1, &slot.instanceVBO);
+		glBindBuffer(GL_ARRAY_BUFFER, slot.instanceVBO);
+		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)0);
+		glEnableVertexAttribArray(1);
+		glVertexAttribDivisor(1, 1);
+	}
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	// Chunks around the focus, nearest first so the player's surroundings arrive before the edges
+	loadOffsets.clear();
+	for (int y = -settings.loadRadius; y <= settings.loadRadius; y++)
+		for (int x = -settings.loadRadius; x <= settings.loadRadius; x++) loadOffsets.push_back(glm::ivec2(x, y));
+	std::stable_sort(loadOffsets.begin(), loadOffsets.end(), [](glm::ivec2 a, glm::ivec2 b) {return a.x * a.x + a.y * a.y < b.x * b.x + b.y * b.y;});
+
+	finished.reserve(slots.size());
+	finishedSwap.reserve(slots.size());
+}
+
+void ChunkStreamer::Start(ThreadPool * workerPool, const Level * level, ChunkSource chunkSource) {
+	pool = workerPool;
+	baseLevel = level;
+	source = std::move(chunkSource);
+}
+
+bool ChunkStreamer::Update(glm::vec2 focus) {
+	PROFILE_SCOPE("ChunkStreamer::Update");
+	glm::ivec2 focusChunk = ChunkAt(focus);
+	bool changed = false;
+
+	// Chunks the workers are done with
+	{
+		std::lock_guard<std::mutex> lock(finishedMutex);
+		finishedSwap.swap(finished);
+	}
+	for (int slot : finishedSwap) slots[slot].state = CHUNK_LOADED;
+	finishedSwap.clear();
+
+	// Request the missing chunks around the focus, making room from the far ones
+	for (glm::ivec2 offset : loadOffsets) {
+		glm::ivec2 chunk = focusChunk + offset;
+		if (FindSlot(chunk) >= 0) continue;
+
+		int slot = FreeSlot();
+		if (slot < 0) {
+			slot = FarthestSlot(focusChunk, true);
+			if (slot < 0) break; // every slot is in use around the focus
+			changed |= slots[slot].resident;
+			Evict(slot);
+		}
+		Request(slot, chunk);
+	}
+
+	// Upload the loaded ones within the budget; loads that were passed by are dropped
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	int uploads = 0;
+	for (int i = 0; i < (int)slots.size(); i++) {
+		if (slots[i].state != CHUNK_LOADED) continue;
+		glm::ivec2 distance = glm::abs(slots[i].chunk - focusChunk);
+		if (glm::max(distance.x, distance.y) > settings.loadRadius) {
+			Evict(i);
+			continue;
+		}
+		if (uploads > 0 && std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() > settings.uploadBudgetMs) break;
+		Upload(i);
+		uploads++;
+		changed = true;
+	}
+
+	// Stay under the memory budget, dropping the farthest chunks outside the load radius
+	while (residentBytes > settings.memoryBudget) {
+		int slot = FarthestSlot(focusChunk, true);
+		if (slot < 0) break; // the budget is too small for the load radius, keep what is around the focus
+		changed |= slots[slot].resident;
+		Evict(slot);
+	}
+	return changed;
+}
+
+void ChunkStreamer::Draw(glm::vec4 region, const glm::mat4& viewProjection) {
+	PROFILE_SCOPE("ChunkStreamer::Draw");
+	if (numOfResident == 0) return;
+
+	shaderProgram.activate();
+	shaderProgram.setMat4Uniform("viewProjection", viewProjection);
+
+	Collider view = {region.x, region.z, region.y, region.w};
+	for (const ChunkSlot& slot : slots) {
+		if (slot.state != CHUNK_RESIDENT || slot.platforms.empty() || !Overlaps(slot.extent, view)) continue;
+		glBindVertexArray(slot.vaoId);
+		glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, (GLsizei)slot.platforms.size());
+	}
+
+	shaderProgram.deactivate();
+	glBindVertexArray(0);
+}
+
+void ChunkStreamer::Delete() {
+	for (ChunkSlot& slot : slots) {
+		glDeleteVertexArrays(1, &slot.vaoId);
+		glDeleteBuffers(1, &slot.instanceVBO);
+	}
+	glDeleteBuffers(1, &quadVBO);
+	glDeleteBuffers(1, &quadEBO);
+	slots.clear();
+}
+
+
+glm::ivec2 ChunkStreamer::ChunkAt(glm::vec2 position) const {
+	return glm::ivec2(glm::floor(position / settings.chunkSize));
+}
+
+Collider ChunkStreamer::ChunkRegion(glm::ivec2 chunk) const {
+	glm::vec2 lower = glm::vec2(chunk) * settings.chunkSize, upper = lower + settings.chunkSize;
+	return {lower.x, upper.x, lower.y, upper.y};
+}
+
+
+Collider ChunkStreamer::Bounds() const {
+	return baseLevel->Bounds();
+}
+
+// The base level's platforms first, then those of the resident chunks near the center.
+// When they don't all fit, neither side crowds out the other: the base level gets
+// at least half of the buffer and whatever the chunks leave.
+int ChunkStreamer::QueryColliders(glm::vec2 center, float reach, float velocityY, Collider * colliders, int maxColliders) const {
+	Collider reachBox = {center.x - reach, center.x + reach, center.y - reach, center.y + reach};
+	std::lock_guard<std::mutex> lock(residentMutex);
+
+	int streamed = 0;
+	for (const ChunkSlot& slot : slots) {
+		if (!slot.resident || !Overlaps(slot.extent, reachBox)) continue;
+		for (const Collider& collider : slot.colliders) streamed += Overlaps(collider, reachBox);
+	}
+
+	int baseShare = glm::max(maxColliders - streamed, maxColliders / 2);
+	int base = baseLevel->QueryColliders(center, reach, velocityY, colliders, baseShare);
+	int count = glm::min(base, baseShare);
+
+	for (const ChunkSlot& slot : slots) {
+		if (!slot.resident || !Overlaps(slot.extent, reachBox)) continue;
+		for (const Collider& collider : slot.colliders) {
+			if (!Overlaps(collider, reachBox) || count == maxColliders) continue;
+			colliders[count++] = collider;
+		}
+	}
+	return base + streamed;
+}
+
+
+ChunkSource ChunkStreamer::LevelFiles(const std::string & directory) {
+	return [directory](glm::ivec2 chunk, const Collider &region, std::vector<glm::vec4> &platforms) {
+		std::string path = directory + "/" + std::to_string(chunk.x) + "_" + std::to_string(chunk.y) + ".lvl";
+		FileData file;
+		if (!FileSystem::ReadFile(path.c_str(), file)) return; // nothing in this chunk
+
+		Level level;
+		if (!level.Parse(file.Text(), path.c_str())) return;
+		glm::vec4 offset = glm::vec4(region.leftSide, region.lowerSide, 0.0f, 0.0f);
+		for (int i = 0; i < level.NumOfPlatforms(); i++) platforms.push_back(level.platformsInstances[i] + offset);
+	};
+}
+
+
+
+
+// Private Functions:
+
+int ChunkStreamer::FindSlot(glm::ivec2 chunk) const {
+	for (int i = 0; i < (int)slots.size(); i++) {
+		if (slots[i].state != CHUNK_FREE && slots[i].chunk == chunk) return i;
+	}
+	return -1;
+}
+
+int ChunkStreamer::FreeSlot() const {
+	for (int i = 0; i < (int)slots.size(); i++) {
+		if (slots[i].state == CHUNK_FREE) return i;
+	}
+	return -1;
+}
+
+// Loaded or resident slot farthest from the focus (a loading one still belongs to a worker), -1 when there is none
+int ChunkStreamer::FarthestSlot(glm::ivec2 focusChunk, bool onlyOutsideRadius) const {
+	int farthest = -1, farthestDistance = -1;
+	for (int i = 0; i < (int)slots.size(); i++) {
+		const ChunkSlot& slot = slots[i];
+		if (slot.state != CHUNK_LOADED && slot.state != CHUNK_RESIDENT) continue;
+
+		glm::ivec2 offset = slot.chunk - focusChunk;
+		if (onlyOutsideRadius && glm::max(glm::abs(offset.x), glm::abs(offset.y)) <= settings.loadRadius) continue;
+		int distance = offset.x * offset.x + offset.y * offset.y;
+		if (distance > farthestDistance) farthest = i, farthestDistance = distance;
+	}
+	return farthest;
+}
+
+// The slot's vectors keep their capacity, so once every slot has held a chunk the workers stop allocating
+void ChunkStreamer::Request(int slot, glm::ivec2 chunk) {
+	slots[slot].chunk = chunk;
+	slots[slot].state = CHUNK_LOADING;
+
+	pool->Submit([this, slot] {
+		PROFILE_SCOPE("ChunkStreamer::Load");
+		ChunkSlot& loading = slots[slot];
+		loading.platforms.clear();
+		source(loading.chunk, ChunkRegion(loading.chunk), loading.platforms);
+
+		loading.colliders.resize(loading.platforms.size());
+		loading.extent = ChunkRegion(loading.chunk);
+		for (size_t i = 0; i < loading.platforms.size(); i++) {
+			glm::vec2 center = glm::vec2(loading.platforms[i]), halfSize = 0.5f * glm::vec2(loading.platforms[i].z, loading.platforms[i].w);
+			Collider& collider = loading.colliders[i];
+			collider = {center.x - halfSize.x, center.x + halfSize.x, center.y - halfSize.y, center.y + halfSize.y};
+			loading.extent = {glm::min(loading.extent.leftSide, collider.leftSide), glm::max(loading.extent.rightSide, collider.rightSide),
+			                  glm::min(loading.extent.lowerSide, collider.lowerSide), glm::max(loading.extent.upperSide, collider.upperSide)};
+		}
+		loading.bytes = loading.platforms.capacity() * sizeof(glm::vec4) + loading.colliders.capacity() * sizeof(Collider) // CPU
+		              + loading.platforms.size() * sizeof(glm::vec4); // GPU
+
+		std::lock_guard<std::mutex> lock(finishedMutex);
+		finished.push_back(slot);
+	});
+}
+
+void ChunkStreamer::Upload(int slot) {
+	ChunkSlot& uploading = slots[slot];
+	glBindBuffer(GL_ARRAY_BUFFER, uploading.instanceVBO);
+	glBufferData(GL_ARRAY_BUFFER, uploading.platforms.size() * sizeof(glm::vec4), uploading.platforms.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	uploading.state = CHUNK_RESIDENT;
+
+	std::lock_guard<std::mutex> lock(residentMutex);
+	uploading.resident = true;
+	numOfResident++;
+	residentBytes += uploading.bytes;
+}
+
+void ChunkStreamer::Evict(int slot) {
+	ChunkSlot& evicted = slots[slot];
+	evicted.state = CHUNK_FREE;
+	if (!evicted.resident) return;
+
+	std::lock_guard<std::mutex> lock(residentMutex);
+	evicted.resident = false;
+	numOfResident--;
+	residentBytes -= evicted.bytes;
+}
@@ -0,0 +1,94 @@
+#include <GLAD/glad.h>
+#include <GLM/glm.hpp>
+
+#include "CircleBatch.h"
+#include "ShaderProgram.h"
+#include "ShaderVariants.h"
+#include "Profiler.h"
+
+
+// Quad corners are padded slightly past the unit circle so the outer half of
+// the anti-aliased edge isn't clipped by the quad itself
+static const float quadPadding = 1.05f;
+static const float quadCorners[4 * 2] = {
+	-quadPadding, -quadPadding, // lower left
+	 quadPadding, -quadPadding, // lower right
+	 quadPadding,  quadPadding, // upper right
+	-quadPadding,  quadPadding  // upper left
+};
+static const unsigned int quadIndices[6] = {0, 1, 3, 1, 2, 3};
+
+// Shader permutation flags (see circleShader.fs)
+static const unsigned int hyperVariant = 1;
+
+
+// Public Functions:
+
+void CircleBatch::Setup(const ShaderSources & shaderSources, unsigned int initialCapacity) {
+	capacity = initialCapacity;
+	instances.reserve(capacity);
+
+	// Create vertex array object
+	glGenVertexArrays(1, &vaoId);
+	glBindVertexArray(vaoId);
+
+	// Shared quad (per vertex)
+	glGenBuffers(1, &quadVBO);
+	glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(quadCorners), quadCorners, GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+
+	glGenBuffers(1, &quadEBO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadEBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(quadIndices), quadIndices, GL_STATIC_DRAW);
+
+	// Center & radius (per instance)
+	glGenBuffers(1, &instanceVBO);
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+	glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(glm::vec3), NULL, GL_STREAM_DRAW);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+	glEnableVertexAttribArray(1);
+	glVertexAttribDivisor(1, 1);
+
+	// Assign shaders to shader program
+	shaderVariants.Setup(shaderSources, {"HYPER"});
+
+	// Unbind VAO
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void CircleBatch::Add(glm::vec2 center, float radius) {
+	instances.push_back(glm::vec3(center, radius));
+}
+
+void CircleBatch::Draw(bool hyper, const glm::mat4& viewProjection) {
+	PROFILE_SCOPE("CircleBatch::Draw");
+	if (instances.empty()) return;
+
+	glBindVertexArray(vaoId);
+	ShaderProgram& shaderProgram = shaderVariants.Get(hyper ? hyperVariant : 0);
+	shaderProgram.activate();
+	shaderProgram.setMat4Uniform("viewProjection", viewProjection);
+
+	// Upload this frame's instances, growing the buffer if needed
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+	if (instances.size() > capacity) capacity = (unsigned int)instances.capacity();
+	glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(glm::vec3), NULL, GL_STREAM_DRAW); // orphan last frame's storage
+	glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(glm::vec3), instances.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, (GLsizei)instances.size());
+	instances.clear();
+
+	shaderProgram.deactivate();
+	glBindVertexArray(0);
+}
+
+void CircleBatch::DeleteVAO() {
+	glDeleteVertexArrays(1, &vaoId);
+	glDeleteBuffers(1, &quadVBO);
+	glDeleteBuffers(1, &quadEBO);
+	glDeleteBuffers(1, &instanceVBO);
+}
@@ -0,0 +1,147 @@
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <climits>
+#endif
+
+#include <string>
+#include <cstring>
+#include <iostream>
+
+#include "FileSystem.h"
+#include "MappedFile.h"
+#include "Lz4.h"
+
+
+MappedFile FileSystem::pack;
+const AssetPackEntry* FileSystem::entries = nullptr;
+uint32_t FileSystem::numOfEntries = 0;
+
+
+uint32_t HashBytes(const unsigned char* bytes, size_t size) {
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < size; i++) hash = (hash ^ bytes[i]) * 16777619u;
+	return hash;
+}
+
+bool SectionInside(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t fileSize) {
+	if (offset > fileSize) return false;
+	return elementSize == 0 || count <= (fileSize - offset) / elementSize;
+}
+
+std::string FileData::Text() const {return std::string((const char*)data, size);}
+
+void FileData::Release() {
+	storage.clear();
+	storage.shrink_to_fit();
+	mapping.Close();
+	data = nullptr;
+	size = 0;
+}
+
+
+// Public Functions:
+
+bool FileSystem::Mount(const char * packPath) {
+	Unmount();
+
+	// copy-on-write: loaders may patch mapped data (e.g. moving platforms) without touching the file
+	if (!pack.Open(packPath, true)) return false;
+
+	const AssetPackHeader* header = (const AssetPackHeader*)pack.Data();
+	if (pack.Size() < sizeof(AssetPackHeader) || std::memcmp(header->magic, "APAK", 4) != 0 || header->version != assetPackVersion
+		|| !SectionInside(header->entriesOffset, header->numOfEntries, sizeof(AssetPackEntry), pack.Size())) {
+		std::cout << "ERROR::FILESYSTEM::INVALID_ASSET_PACK: " << packPath << std::endl;
+		pack.Close();
+		return false;
+	}
+
+	// every entry's bytes must lie inside the pack, ReadFile hands them out unchecked
+	const AssetPackEntry* packEntries = (const AssetPackEntry*)(pack.Data() + header->entriesOffset);
+	for (uint32_t i = 0; i < header->numOfEntries; i++) {
+		const AssetPackEntry& entry = packEntries[i];
+		uint64_t storedSize = (entry.flags & assetCompressedFlag) ? entry.storedSize : entry.size;
+		if (!SectionInside(entry.offset, storedSize, 1, pack.Size())) {
+			std::cout << "ERROR::FILESYSTEM::INVALID_ASSET_PACK: " << packPath << std::endl;
+			pack.Close();
+			return false;
+		}
+	}
+
+	entries = packEntries;
+	numOfEntries = header->numOfEntries;
+	return true;
+}
+
+void FileSystem::Unmount() {
+	pack.Close();
+	entries = nullptr;
+	numOfEntries = 0;
+}
+
+bool FileSystem::ReadFile(const char * path, FileData & file) {
+	file.Release();
+
+	const AssetPackEntry* entry = FindEntry(path);
+	if (entry != nullptr) {
+		unsigned char* stored = pack.Data() + entry->offset;
+
+		if (!(entry->flags & assetCompressedFlag)) {
+			// zero-copy, the caller reads the mapped pages directly
+			file.data = stored;
+			file.size = entry->size;
+			return true;
+		}
+
+		file.storage.resize(entry->size);
+		int decompressedSize = Lz4Decompress(stored, (int)entry->storedSize, file.storage.data(), (int)entry->size);
+		if (decompressedSize != (int)entry->size || HashBytes(file.storage.data(), entry->size) != entry->hash) {
+			std::cout << "ERROR::FILESYSTEM::CORRUPT_ASSET: " << path << std::endl;
+			file.storage.clear();
+			return false;
+		}
+		file.data = file.storage.data();
+		file.size = entry->size;
+		return true;
+	}
+
+	// not packed, fall back to a loose file
+	if (!file.mapping.Open(path, true)) return false;
+	file.data = file.mapping.Data();
+	file.size = file.mapping.Size();
+	return true;
+}
+
+std::string FileSystem::ExecutableDirectory() {
+	char buffer[4096];
+#ifdef _WIN32
+	DWORD length = GetModuleFileNameA(NULL, buffer, sizeof(buffer));
+#else
+	ssize_t length = readlink("/proc/self/exe", buffer, sizeof(buffer) - 1);
+#endif
+	if (length <= 0 || length >= (long)sizeof(buffer)) return "";
+
+	std::string path(buffer, length);
+	size_t separator = path.find_last_of("/\\");
+	return (separator == std::string::npos) ? "" : path.substr(0, separator + 1);
+}
+
+
+
+// Private Functions:
+
+// Entries are sorted by path, binary search them
+const AssetPackEntry* FileSystem::FindEntry(const char * path) {
+	int low = 0, high = (int)numOfEntries - 1;
+	while (low <= high) {
+		int middle = (low + high) / 2;
+		int comparison = std::strncmp(path, entries[middle].path, sizeof(entries[middle].path));
+		if (comparison == 0) return &entries[middle];
+		if (comparison < 0) high = middle - 1;
+		else low = middle + 1;
+	}
+	return nullptr;
+}
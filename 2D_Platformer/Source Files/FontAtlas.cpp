@@ -0,0 +1,38 @@
+#include <cstring>
+#include <iostream>
+
+#include "FontAtlas.h"
+#include "FileSystem.h"
+
+
+// Public Functions:
+
+bool FontAtlas::Load(const char* path) {
+	if (!FileSystem::ReadFile(path, file)) {
+		std::cout << "ERROR::FONT::FILE_NOT_SUCCESSFULLY_READ: " << path << std::endl;
+		return false;
+	}
+
+	// Validate before trusting any offset
+	const CompiledFontHeader* fileHeader = (const CompiledFontHeader*)file.data;
+	if (file.size < sizeof(CompiledFontHeader) || std::memcmp(fileHeader->magic, "FNTA", 4) != 0 || fileHeader->version != compiledFontVersion) {
+		std::cout << "ERROR::FONT::INVALID_FILE: " << path << std::endl;
+		file.Release();
+		return false;
+	}
+
+	uint64_t glyphsEnd = fileHeader->glyphsOffset + (uint64_t)fileHeader->numOfGlyphs * sizeof(CompiledGlyph);
+	uint64_t kerningEnd = fileHeader->kerningOffset + (uint64_t)fileHeader->numOfKerningPairs * sizeof(CompiledKerningPair);
+	uint64_t pixelsEnd = fileHeader->pixelsOffset + (uint64_t)fileHeader->atlasWidth * fileHeader->atlasHeight;
+	if (glyphsEnd > file.size || kerningEnd > file.size || pixelsEnd > file.size) {
+		std::cout << "ERROR::FONT::TRUNCATED_FILE: " << path << std::endl;
+		file.Release();
+		return false;
+	}
+
+	header = fileHeader;
+	glyphs = (const CompiledGlyph*)(file.data + fileHeader->glyphsOffset);
+	kerningPairs = (const CompiledKerningPair*)(file.data + fileHeader->kerningOffset);
+	pixels = file.data + fileHeader->pixelsOffset;
+	return true;
+}
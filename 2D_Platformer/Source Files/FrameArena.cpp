@@ -0,0 +1,52 @@
+#include <cstdlib>
+#include <cstdint>
+#include <new>
+
+#include "FrameArena.h"
+
+
+// Public Functions:
+
+void FrameArena::Setup(size_t initialCapacity) {
+	capacity = initialCapacity;
+	memory = (unsigned char*)std::malloc(capacity);
+	offset = 0;
+	overflowBlocks.reserve(16);
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment) {
+	// align the current position (alignment is a power of two)
+	size_t alignedOffset = (offset + alignment - 1) & ~(alignment - 1);
+	if (memory != nullptr && alignedOffset + size <= capacity) {
+		offset = alignedOffset + size;
+		return memory + alignedOffset;
+	}
+
+	// out of room this frame: borrow from the heap, grow at the next Reset
+	void* block = std::malloc(size + alignment);
+	if (block == nullptr) throw std::bad_alloc();
+	overflowBlocks.push_back(block);
+	overflowBytes += size + alignment;
+	return (void*)(((uintptr_t)block + alignment - 1) & ~(uintptr_t)(alignment - 1));
+}
+
+void FrameArena::Reset() {
+	if (!overflowBlocks.empty()) {
+		for (void* block : overflowBlocks) std::free(block);
+		overflowBlocks.clear();
+
+		// big enough for the frame that overflowed, with headroom
+		capacity = (capacity + overflowBytes) * 2;
+		std::free(memory);
+		memory = (unsigned char*)std::malloc(capacity);
+		overflowBytes = 0;
+	}
+	offset = 0;
+}
+
+void FrameArena::Shutdown() {
+	Reset();
+	std::free(memory);
+	memory = nullptr;
+	capacity = 0;
+}
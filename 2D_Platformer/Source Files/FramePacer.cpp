@@ -0,0 +1,103 @@
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <timeapi.h>
+#endif
+
+#include <cmath>
+#include <algorithm>
+#include <thread>
+#include <iostream>
+
+#include <GLFW/glfw3.h>
+
+#include "FramePacer.h"
+#include "Profiler.h"
+
+
+// Public Functions:
+
+void FramePacer::Setup(double targetFps, Vsync_Mode mode) {
+#ifdef _WIN32
+	timeBeginPeriod(1); // 1 ms scheduler granularity, otherwise Sleep() rounds up to ~15.6 ms
+#endif
+	SetVsync(mode);
+	SetTargetFps(targetFps);
+	lastFrame = Clock::now();
+}
+
+void FramePacer::SetTargetFps(double targetFps) {
+	limited = targetFps > 0.0;
+	if (limited) framePeriod = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetFps));
+	else framePeriod = Clock::duration::zero();
+	nextDeadline = Clock::now() + framePeriod;
+}
+
+void FramePacer::WaitForNextFrame() {
+	PROFILE_SCOPE("FramePacer::WaitForNextFrame");
+	if (limited) {
+		// sleep through most of the remaining time
+		Clock::time_point now = Clock::now();
+		double remaining = std::chrono::duration<double>(nextDeadline - now).count();
+		if (remaining > spinThreshold) {
+			std::chrono::duration<double> request(remaining - spinThreshold);
+			std::this_thread::sleep_for(request);
+
+			// adapt the spin margin to how much the OS actually oversleeps
+			double overshoot = std::chrono::duration<double>(Clock::now() - now).count() - request.count();
+			spinThreshold = std::max(0.0005, 0.9 * spinThreshold + 0.1 * (1.5 * overshoot));
+		}
+
+		// spin for the last bit (sub-millisecond accuracy)
+		while (Clock::now() < nextDeadline) std::this_thread::yield();
+
+		// schedule the next deadline, don't try to catch up after a long stall
+		nextDeadline += framePeriod;
+		now = Clock::now();
+		if (nextDeadline < now) nextDeadline = now + framePeriod;
+	}
+
+	RecordFrame(Clock::now());
+}
+
+double FramePacer::GetAverageFrameTime() {return meanFrameTime * 1000.0;}
+double FramePacer::GetJitter() {return frameCount > 1 ? std::sqrt(frameTimeM2 / (frameCount - 1)) * 1000.0 : 0.0;}
+
+void FramePacer::PrintReport() {
+	std::cout << "Frames: " << frameCount
+	          << ", average: " << GetAverageFrameTime() << " ms"
+	          << ", jitter: " << GetJitter() << " ms"
+	          << ", worst: " << worstFrameTime * 1000.0 << " ms" << std::endl;
+}
+
+void FramePacer::Shutdown() {
+#ifdef _WIN32
+	timeEndPeriod(1);
+#endif
+}
+
+
+
+// Private Functions:
+
+void FramePacer::SetVsync(Vsync_Mode mode) {
+	if (mode == VSYNC_ADAPTIVE) {
+		// late frames tear instead of waiting a whole extra refresh; fall back to regular vsync if unsupported
+		bool tearSupported = glfwExtensionSupported("WGL_EXT_swap_control_tear") || glfwExtensionSupported("GLX_EXT_swap_control_tear");
+		glfwSwapInterval(tearSupported ? -1 : 1);
+	} else {
+		glfwSwapInterval(mode == VSYNC_ON ? 1 : 0);
+	}
+}
+
+void FramePacer::RecordFrame(Clock::time_point now) {
+	double frameTime = std::chrono::duration<double>(now - lastFrame).count();
+	lastFrame = now;
+
+	frameCount++;
+	double delta = frameTime - meanFrameTime;
+	meanFrameTime += delta / frameCount;
+	frameTimeM2 += delta * (frameTime - meanFrameTime);
+	if (frameTime > worstFrameTime) worstFrameTime = frameTime;
+}
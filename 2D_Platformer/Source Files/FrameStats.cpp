@@ -0,0 +1,122 @@
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+#include "FrameStats.h"
+
+
+static const double budgetMicroseconds[2] = {1e6 / 60.0, 1e6 / 120.0};
+
+
+// Public Functions:
+
+void FrameStats::Record(double frameTime) {
+	uint64_t microseconds = (uint64_t)std::max(0.0, std::round(frameTime * 1e6));
+
+	counts[BucketIndex(microseconds)]++;
+	numOfFrames++;
+	minMicroseconds = std::min(minMicroseconds, microseconds);
+	maxMicroseconds = std::max(maxMicroseconds, microseconds);
+	sumMicroseconds += (double)microseconds;
+
+	for (int budget = 0; budget < 2; budget++)
+		if (microseconds > budgetMicroseconds[budget]) missedBudgets[budget]++;
+}
+
+void FrameStats::Reset() {
+	*this = FrameStats();
+}
+
+double FrameStats::Min() const {return numOfFrames == 0 ? 0.0 : minMicroseconds / 1000.0;}
+double FrameStats::Max() const {return maxMicroseconds / 1000.0;}
+double FrameStats::Mean() const {return numOfFrames == 0 ? 0.0 : sumMicroseconds / numOfFrames / 1000.0;}
+
+// Value below which the given percent of frames fall, reported as the middle
+// of its bucket (clamped to the recorded range)
+double FrameStats::Percentile(double percent) const {
+	if (numOfFrames == 0) return 0.0;
+
+	uint64_t rank = (uint64_t)std::ceil(percent / 100.0 * numOfFrames);
+	rank = std::max<uint64_t>(1, std::min(rank, numOfFrames));
+
+	uint64_t seen = 0;
+	for (int i = 0; i < numOfBuckets; i++) {
+		seen += counts[i];
+		if (seen >= rank) {
+			uint64_t middle = (BucketLowest(i) + BucketHighest(i)) / 2;
+			return std::min(std::max(middle, minMicroseconds), maxMicroseconds) / 1000.0;
+		}
+	}
+	return Max();
+}
+
+void FrameStats::PrintReport() const {
+	std::cout << "Frame times over " << numOfFrames << " frames (ms): "
+	          << "min " << Min() << ", mean " << Mean()
+	          << ", p50 " << Percentile(50.0) << ", p95 " << Percentile(95.0)
+	          << ", p99 " << Percentile(99.0) << ", p99.9 " << Percentile(99.9)
+	          << ", max " << Max() << std::endl;
+	std::cout << "Missed budgets: " << missedBudgets[BUDGET_60HZ] << " frames over 16.6 ms, "
+	          << missedBudgets[BUDGET_120HZ] << " frames over 8.3 ms" << std::endl;
+}
+
+// One flat object per run, for dashboards comparing builds
+bool FrameStats::WriteJson(const char* path) const {
+	std::ofstream jsonStream(path);
+	jsonStream << "{\n"
+	           << "  \"build\": \"" << __DATE__ << " " << __TIME__ << "\",\n"
+#ifdef _DEBUG
+	           << "  \"configuration\": \"Debug\",\n"
+#else
+	           << "  \"configuration\": \"Release\",\n"
+#endif
+	           << "  \"frames\": " << numOfFrames << ",\n"
+	           << "  \"min_ms\": " << Min() << ",\n"
+	           << "  \"mean_ms\": " << Mean() << ",\n"
+	           << "  \"p50_ms\": " << Percentile(50.0) << ",\n"
+	           << "  \"p95_ms\": " << Percentile(95.0) << ",\n"
+	           << "  \"p99_ms\": " << Percentile(99.0) << ",\n"
+	           << "  \"p999_ms\": " << Percentile(99.9) << ",\n"
+	           << "  \"max_ms\": " << Max() << ",\n"
+	           << "  \"over_16_6_ms\": " << missedBudgets[BUDGET_60HZ] << ",\n"
+	           << "  \"over_8_3_ms\": " << missedBudgets[BUDGET_120HZ] << "\n"
+	           << "}\n";
+
+	if (!jsonStream) {
+		std::cout << "ERROR::FRAME_STATS::FILE_NOT_SUCCESSFULLY_WRITTEN: " << path << std::endl;
+		return false;
+	}
+	return true;
+}
+
+
+
+// Private Functions:
+
+int FrameStats::BucketIndex(uint64_t microseconds) {
+	if (microseconds < (1u << subBucketBits)) return (int)microseconds;
+
+	int highestBit = 0;
+	for (uint64_t v = microseconds; v > 1; v >>= 1) highestBit++;
+
+	int shift = highestBit - (subBucketBits - 1);
+	if (shift > maxShift) shift = maxShift;
+	uint64_t subBucket = std::min<uint64_t>(microseconds >> shift, 2 * subBucketHalf - 1); // [half, 2 * half)
+	return (1 << subBucketBits) + (shift - 1) * subBucketHalf + (int)(subBucket - subBucketHalf);
+}
+
+uint64_t FrameStats::BucketLowest(int index) {
+	if (index < (1 << subBucketBits)) return (uint64_t)index;
+
+	int shift = (index - (1 << subBucketBits)) / subBucketHalf + 1;
+	uint64_t subBucket = (index - (1 << subBucketBits)) % subBucketHalf + subBucketHalf;
+	return subBucket << shift;
+}
+
+uint64_t FrameStats::BucketHighest(int index) {
+	if (index < (1 << subBucketBits)) return (uint64_t)index;
+
+	int shift = (index - (1 << subBucketBits)) / subBucketHalf + 1;
+	return BucketLowest(index) + ((uint64_t)1 << shift) - 1;
+}
@@ -0,0 +1,152 @@
+#include <vector>
+#include <cstddef>
+
+#include <GLAD/glad.h>
+#include <GLM/glm.hpp>
+
+#include "GpuParticleSystem.h"
+#include "ShaderProgram.h"
+#include "Profiler.h"
+
+
+// Unit quad, scaled & moved per instance in the vertex shader
+static const float quadCorners[4 * 2] = {
+	-0.5f, -0.5f, // lower left
+	 0.5f, -0.5f, // lower right
+	 0.5f,  0.5f, // upper right
+	-0.5f,  0.5f  // upper left
+};
+static const unsigned int quadIndices[6] = {0, 1, 3, 1, 2, 3};
+
+
+// Public Functions:
+
+void GpuParticleSystem::Setup(const ShaderSources & updateSources, const ShaderSources & drawSources, const ParticleMaterial & particleMaterial, int particleCapacity) {
+	capacity = particleCapacity;
+	material = particleMaterial;
+	quietTime = material.maxLife + 1.0f; // nothing alive until the first emit
+
+	// Shared quad (per vertex)
+	glGenBuffers(1, &quadVBO);
+	glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(quadCorners), quadCorners, GL_STATIC_DRAW);
+	glGenBuffers(1, &quadEBO);
+
+	// Both state buffers start with every particle dead (no life left)
+	std::vector<GpuParticle> dead(capacity, GpuParticle{glm::vec4(0.0f), glm::vec4(0.0f)});
+	glGenBuffers(2, stateBuffers);
+	for (int i = 0; i < 2; i++) {
+		glBindBuffer(GL_ARRAY_BUFFER, stateBuffers[i]);
+		glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(GpuParticle), dead.data(), GL_DYNAMIC_COPY);
+	}
+
+	glGenVertexArrays(2, updateVaos);
+	glGenVertexArrays(2, drawVaos);
+	for (int i = 0; i < 2; i++) {
+		// Update: one point per particle (per vertex)
+		glBindVertexArray(updateVaos[i]);
+		glBindBuffer(GL_ARRAY_BUFFER, stateBuffers[i]);
+		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (void*)offsetof(GpuParticle, motion));
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (void*)offsetof(GpuParticle, life));
+		glEnableVertexAttribArray(1);
+
+		// Draw: the quad (per vertex), placed by a particle (per instance)
+		glBindVertexArray(drawVaos[i]);
+		glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+		glEnableVertexAttribArray(0);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadEBO);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(quadIndices), quadIndices, GL_STATIC_DRAW);
+
+		glBindBuffer(GL_ARRAY_BUFFER, stateBuffers[i]);
+		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (void*)offsetof(GpuParticle, motion));
+		glEnableVertexAttribArray(1);
+		glVertexAttribDivisor(1, 1);
+		glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(GpuParticle), (void*)offsetof(GpuParticle, life));
+		glEnableVertexAttribArray(2);
+		glVertexAttribDivisor(2, 1);
+	}
+
+	// Assign shaders to shader programs, the update's outputs are the next state
+	ShaderSources feedbackSources = updateSources;
+	feedbackSources.feedbackVaryings = {"motion", "life"};
+	updateProgram.Setup(feedbackSources);
+	drawProgram.Setup(drawSources);
+
+	// Unbind VAO
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void GpuParticleSystem::Emit(glm::vec2 position, int count) {
+	emitterPosition = position;
+	pendingSpawns = glm::min(pendingSpawns + count, capacity);
+	quietTime = 0.0f;
+}
+
+void GpuParticleSystem::Update(float deltaTime) {
+	PROFILE_SCOPE("GpuParticleSystem::Update");
+	if (quietTime > material.maxLife) return; // all dead
+	bool spawning = pendingSpawns > 0;
+
+	updateProgram.activate();
+	updateProgram.setFloatUniform("deltaTime", deltaTime);
+	updateProgram.setFloatUniform("damping", glm::max(1.0f - material.drag * deltaTime, 0.0f));
+	updateProgram.setFloatUniform("fall", material.gravity * deltaTime);
+	updateProgram.setIntUniform("capacity", capacity);
+	updateProgram.setIntUniform("spawnStart", spawnCursor);
+	updateProgram.setIntUniform("spawnCount", pendingSpawns);
+	updateProgram.setIntUniform("frameSeed", (int)frame++);
+	updateProgram.setVec2Uniform("emitterPosition", emitterPosition);
+	updateProgram.setVec2Uniform("minVelocity", material.minVelocity);
+	updateProgram.setVec2Uniform("maxVelocity", material.maxVelocity);
+	updateProgram.setVec2Uniform("lifeRange", material.minLife, material.maxLife);
+	updateProgram.setVec2Uniform("sizeRange", material.minSize, material.maxSize);
+	spawnCursor = (spawnCursor + pendingSpawns) % capacity;
+	pendingSpawns = 0;
+
+	// Read the current state, write the other buffer, rasterize nothing
+	glEnable(GL_RASTERIZER_DISCARD);
+	glBindVertexArray(updateVaos[current]);
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, stateBuffers[1 - current]);
+	glBeginTransformFeedback(GL_POINTS);
+	glDrawArrays(GL_POINTS, 0, capacity);
+	glEndTransformFeedback();
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+	glDisable(GL_RASTERIZER_DISCARD);
+	current = 1 - current;
+
+	// only the passes after the spawning one take life off the newest particles
+	quietTime = spawning ? 0.0f : quietTime + deltaTime;
+
+	updateProgram.deactivate();
+	glBindVertexArray(0);
+}
+
+void GpuParticleSystem::Draw(const glm::mat4 & viewProjection) {
+	PROFILE_SCOPE("GpuParticleSystem::Draw");
+	if (quietTime > material.maxLife) return;
+
+	drawProgram.activate();
+	drawProgram.setMat4Uniform("viewProjection", viewProjection);
+	drawProgram.setVec4Uniform("particleColor", material.color);
+
+	// every slot, dead ones collapse to nothing in the vertex shader
+	glBindVertexArray(drawVaos[current]);
+	glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, capacity);
+
+	drawProgram.deactivate();
+	glBindVertexArray(0);
+}
+
+void GpuParticleSystem::DeleteVAO() {
+	glDeleteVertexArrays(2, updateVaos);
+	glDeleteVertexArrays(2, drawVaos);
+	glDeleteBuffers(2, stateBuffers);
+	glDeleteBuffers(1, &quadVBO);
+	glDeleteBuffers(1, &quadEBO);
+}
+
+
+int GpuParticleSystem::Capacity() const {return capacity;}
@@ -3,9 +3,11 @@
 
 #include "Ground.h"
 #include "ShaderProgram.h"
+#include "Profiler.h"
 
-// Constructor
-Ground::Ground(float positionAttribute[], unsigned int positionIndices[], const char * vrtxShaderPath, const char * frgmtShaderPath) {
+// Public Functions:
+
+void Ground::Setup(float positionAttribute[], unsigned int positionIndices[], const ShaderSources & shaderSources) {
 	upperSide = glm::max(positionAttribute[1], glm::max(positionAttribute[4], positionAttribute[7]));
 	lowerSide = glm::min(positionAttribute[1], glm::min(positionAttribute[4], positionAttribute[7]));
 	rightSide = glm::max(positionAttribute[0], glm::max(positionAttribute[3], positionAttribute[6]));
@@ -30,18 +32,17 @@ Ground::Ground(float positionAttribute[], unsigned int positionIndices[], const
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, 6 * sizeof(unsigned int), positionIndices, GL_STATIC_DRAW);
 
 	// Assign shaders to shader program
-	shaderProgram.Setup(vrtxShaderPath, frgmtShaderPath);
+	shaderProgram.Setup(shaderSources);
 
 	// Unbind VAO
 	glBindVertexArray(0);
 }
 
-
-// Public Functions:
-
-void Ground::Draw() {
+void Ground::Draw(const glm::mat4& viewProjection) {
+	PROFILE_SCOPE("Ground::Draw");
 	glBindVertexArray(vaoId);
 	shaderProgram.activate();
+	shaderProgram.setMat4Uniform("viewProjection", viewProjection);
 
 	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 
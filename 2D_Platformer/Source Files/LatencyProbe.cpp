@@ -0,0 +1,125 @@
+#include <chrono>
+#include <random>
+#include <iostream>
+
+#include <GLAD/glad.h>
+
+#include "LatencyProbe.h"
+#include "Simulation.h"
+#include "FrameStats.h"
+
+
+static const std::chrono::milliseconds probeInterval(200); // plus up to 100 ms of jitter, so probes don't lock to the frame rate
+static const size_t maxPendingProbes = 8;
+
+
+// Public Functions:
+
+void LatencyProbe::SetEnabled(bool enable) {
+	if (enable == enabled) return;
+	enabled = enable;
+
+	if (!enabled) {
+		Shutdown(); // drop unfinished probes
+		PrintReport();
+	} else {
+		nextInjection = Clock::now();
+	}
+}
+
+// A real key press happens at some moment between two polls and is only seen at
+// the next one, so the probe's press time is drawn from the interval since the last poll
+void LatencyProbe::Inject(Simulation & simulation, std::chrono::steady_clock::time_point previousPoll) {
+	Clock::time_point now = Clock::now();
+	if (!enabled || now < nextInjection || pending.size() >= maxPendingProbes) return;
+
+	std::uniform_real_distribution<double> unit(0.0, 1.0);
+	Probe probe;
+	probe.id = ++numOfInjected;
+	probe.pressTime = previousPoll + std::chrono::duration_cast<Clock::duration>((now - previousPoll) * unit(random));
+	pending.push_back(probe);
+
+	simulation.QueueInput(INPUT_PROBE, true, now); // stamped like a real key event
+	nextInjection = now + probeInterval + std::chrono::duration_cast<Clock::duration>(probeInterval * 0.5 * unit(random));
+}
+
+void LatencyProbe::FrameSubmitted(const WorldSnapshot & world) {
+	for (Probe& probe : pending) {
+		if (probe.submitted || probe.id > world.probesApplied) continue;
+
+		probe.tickTime = world.probeTickTime;
+		probe.submitTime = Clock::now();
+		probe.submitted = true;
+
+		// GPU timestamp once all of this frame's commands are done, plus a fence as a cross-check
+		glGenQueries(1, &probe.query);
+		glQueryCounter(probe.query, GL_TIMESTAMP);
+		glGetInteger64v(GL_TIMESTAMP, &probe.gpuReference);
+		probe.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+}
+
+void LatencyProbe::FrameSwapped() {
+	Clock::time_point now = Clock::now();
+	for (Probe& probe : pending) {
+		if (probe.submitted && !probe.swapped) probe.swapTime = now, probe.swapped = true;
+	}
+}
+
+void LatencyProbe::Collect() {
+	for (size_t i = 0; i < pending.size();) {
+		Probe& probe = pending[i];
+		if (!probe.swapped) {i++; continue;}
+
+		// the fence is only seen once per frame, so it bounds the GPU finish from above
+		GLenum fenceState = glClientWaitSync(probe.fence, 0, 0);
+		GLint queryReady = 0;
+		glGetQueryObjectiv(probe.query, GL_QUERY_RESULT_AVAILABLE, &queryReady);
+		if ((fenceState != GL_ALREADY_SIGNALED && fenceState != GL_CONDITION_SATISFIED) || !queryReady) {i++; continue;}
+
+		GLuint64 gpuTime;
+		glGetQueryObjectui64v(probe.query, GL_QUERY_RESULT, &gpuTime);
+		Clock::time_point gpuDone = probe.submitTime + std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds((GLint64)gpuTime - probe.gpuReference));
+
+		Finish(probe, gpuDone, Clock::now());
+		pending.erase(pending.begin() + i);
+	}
+}
+
+void LatencyProbe::PrintReport() const {
+	if (toGpuDone.NumOfFrames() == 0) {
+		std::cout << "Input latency: no probes completed" << std::endl;
+		return;
+	}
+
+	std::cout << "Input latency over " << toGpuDone.NumOfFrames() << " probes (ms, p50 / p95 / p99 / max):" << std::endl;
+	const FrameStats* stages[] = {&toTick, &toSubmit, &toSwap, &toGpuDone, &toFence};
+	const char* names[] = {"  press -> tick applied:  ", "  press -> frame submit:  ", "  press -> swap returned: ", "  press -> GPU finished:  ", "  press -> fence seen:    "};
+	for (int i = 0; i < 5; i++) {
+		std::cout << names[i] << stages[i]->Percentile(50.0) << " / " << stages[i]->Percentile(95.0) << " / "
+		          << stages[i]->Percentile(99.0) << " / " << stages[i]->Max() << std::endl;
+	}
+}
+
+void LatencyProbe::Shutdown() {
+	for (Probe& probe : pending) {
+		if (probe.query != 0) glDeleteQueries(1, &probe.query);
+		if (probe.fence != 0) glDeleteSync(probe.fence);
+	}
+	pending.clear();
+}
+
+
+
+// Private Functions:
+
+void LatencyProbe::Finish(Probe & probe, Clock::time_point gpuDone, Clock::time_point fenceSeen) {
+	toTick.Record(std::chrono::duration<double>(probe.tickTime - probe.pressTime).count());
+	toSubmit.Record(std::chrono::duration<double>(probe.submitTime - probe.pressTime).count());
+	toSwap.Record(std::chrono::duration<double>(probe.swapTime - probe.pressTime).count());
+	toGpuDone.Record(std::chrono::duration<double>(gpuDone - probe.pressTime).count());
+	toFence.Record(std::chrono::duration<double>(fenceSeen - probe.pressTime).count());
+
+	glDeleteQueries(1, &probe.query);
+	glDeleteSync(probe.fence);
+}
@@ -0,0 +1,336 @@
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+#include <GLM/glm.hpp>
+
+#include "Level.h"
+#include "FileSystem.h"
+
+
+// Level files are plain text, one command per line, '#' starts a comment:
+//   ground   <upperline>
+//   spawn    <x> <y>
+//   size     <width> <height>             default size for the following platforms
+//   platform <x> <y> [<width> <height>]
+//   mover    <platform> <dx> <dy> <period>
+//   bounds   <left> <right> <top>         extent of the world, defaults to the screen
+// Coordinates are world units; the default camera shows -1..1 on both axes.
+
+static const char* SkipBlanks(const char* c) {
+	while (*c == ' ' || *c == '\t' || *c == '\r') c++;
+	return c;
+}
+
+// Reads up to maxCount numbers from the current line, returns how many were read
+static int ReadNumbers(const char*& c, float out[], int maxCount) {
+	int count = 0;
+	while (count < maxCount) {
+		c = SkipBlanks(c);
+		char* end;
+		float value = std::strtof(c, &end);
+		if (end == c) break;
+		out[count++] = value;
+		c = end;
+	}
+	return count;
+}
+
+static uint64_t AlignOffset(uint64_t offset) {
+	return (offset + compiledLevelAlignment - 1) / compiledLevelAlignment * compiledLevelAlignment;
+}
+
+
+// Public Functions:
+
+bool Level::Load(const char * path) {
+	FileData file;
+	if (!FileSystem::ReadFile(path, file)) {
+		std::cout << "ERROR::LEVEL::FILE_NOT_SUCCESSFULLY_READ: " << path << std::endl;
+		return false;
+	}
+	return Parse(file.Text(), path);
+}
+
+bool Level::Parse(const std::string & source, const char * path) {
+	Clear();
+	Reserve((int)std::count(source.begin(), source.end(), '\n') + 1); // at most one platform per line
+
+	glm::vec2 platformSize(0.5f, 0.16f);
+	const char* c = source.c_str();
+	int lineNumber = 0;
+
+	while (*c) {
+		lineNumber++;
+		c = SkipBlanks(c);
+
+		// command name
+		const char* word = c;
+		while (*c && *c != ' ' && *c != '\t' && *c != '\r' && *c != '\n' && *c != '#') c++;
+		size_t wordLength = c - word;
+
+		float numbers[4];
+		int count = ReadNumbers(c, numbers, 4);
+		bool valid = true;
+
+		if (wordLength == 0) {
+			valid = (count == 0); // blank or comment line
+		} else if (wordLength == 8 && std::strncmp(word, "platform", 8) == 0) {
+			if (count == 2)      AddPlatform(glm::vec2(numbers[0], numbers[1]), platformSize);
+			else if (count == 4) AddPlatform(glm::vec2(numbers[0], numbers[1]), glm::vec2(numbers[2], numbers[3]));
+			else valid = false;
+		} else if (wordLength == 6 && std::strncmp(word, "ground", 6) == 0) {
+			if (count == 1) groundUpperline = numbers[0];
+			else valid = false;
+		} else if (wordLength == 5 && std::strncmp(word, "spawn", 5) == 0) {
+			if (count == 2) spawnPoint = glm::vec2(numbers[0], numbers[1]);
+			else valid = false;
+		} else if (wordLength == 4 && std::strncmp(word, "size", 4) == 0) {
+			if (count == 2) platformSize = glm::vec2(numbers[0], numbers[1]);
+			else valid = false;
+		} else if (wordLength == 6 && std::strncmp(word, "bounds", 6) == 0) {
+			if (count == 3 && numbers[0] < numbers[1]) leftBound = numbers[0], rightBound = numbers[1], topBound = numbers[2];
+			else valid = false;
+		} else if (wordLength == 5 && std::strncmp(word, "mover", 5) == 0) {
+			int platform = (count == 4) ? (int)numbers[0] : -1;
+			if (platform >= 0 && platform < NumOfPlatforms() && numbers[3] > 0.0f) {
+				glm::vec2 basePosition = glm::vec2(platformsInstances[platform]);
+				movers.push_back({platform, basePosition, glm::vec2(numbers[1], numbers[2]), numbers[3]});
+			} else {
+				valid = false;
+			}
+		} else {
+			valid = false;
+		}
+
+		// rest of the line must be a comment or nothing
+		c = SkipBlanks(c);
+		if (*c != '#' && *c != '\n' && *c != '\0') valid = false;
+		if (!valid) std::cout << "ERROR::LEVEL::INVALID_LINE " << lineNumber << " in " << path << std::endl;
+
+		while (*c && *c != '\n') c++;
+		if (*c == '\n') c++;
+	}
+
+	return true;
+}
+
+bool Level::LoadCompiled(const char * path) {
+	Clear();
+
+	// mapped copy-on-write, so moving platforms can still update their (few) pages
+	if (!FileSystem::ReadFile(path, compiledFile)) return false;
+
+	unsigned char* base = compiledFile.data;
+	size_t fileSize = compiledFile.size;
+	CompiledLevelHeader* header = (CompiledLevelHeader*)base;
+
+	if (fileSize < sizeof(CompiledLevelHeader) || std::memcmp(header->magic, "LVLB", 4) != 0 || header->version != compiledLevelVersion) {
+		std::cout << "ERROR::LEVEL::INVALID_COMPILED_LEVEL: " << path << std::endl;
+		compiledFile.Release();
+		return false;
+	}
+
+	// the world must have room between its sides and above the ground, like the text bounds command (NaN fails too)
+	if (!(header->leftBound < header->rightBound) || !(header->topBound > header->groundUpperline)) {
+		std::cout << "ERROR::LEVEL::INVALID_COMPILED_LEVEL: " << path << std::endl;
+		compiledFile.Release();
+		return false;
+	}
+
+	// every section must lie inside the file, aligned for its element type
+	uint64_t count = header->numOfPlatforms;
+	struct Section {uint64_t offset, count, elementSize;} sections[6] = {
+		{header->instancesOffset, count, sizeof(glm::vec4)},
+		{header->leftOffset,  count, sizeof(float)},
+		{header->rightOffset, count, sizeof(float)},
+		{header->lowerOffset, count, sizeof(float)},
+		{header->upperOffset, count, sizeof(float)},
+		{header->moversOffset, header->numOfMovers, sizeof(CompiledMover)}
+	};
+	for (const Section& section : sections) {
+		if (section.offset % compiledLevelAlignment != 0) {
+			std::cout << "ERROR::LEVEL::INVALID_COMPILED_LEVEL: " << path << std::endl;
+			compiledFile.Release();
+			return false;
+		}
+		if (!SectionInside(section.offset, section.count, section.elementSize, fileSize)) {
+			std::cout << "ERROR::LEVEL::TRUNCATED_COMPILED_LEVEL: " << path << std::endl;
+			compiledFile.Release();
+			return false;
+		}
+	}
+
+	// a mover's period divides its phase, the text loader rejects it the same way
+	CompiledMover* compiledMovers = (CompiledMover*)(base + header->moversOffset);
+	for (uint32_t i = 0; i < header->numOfMovers; i++) {
+		if (!(compiledMovers[i].period > 0.0f)) {
+			std::cout << "ERROR::LEVEL::INVALID_COMPILED_LEVEL: " << path << std::endl;
+			compiledFile.Release();
+			return false;
+		}
+	}
+
+	groundUpperline = header->groundUpperline;
+	spawnPoint = glm::vec2(header->spawnX, header->spawnY);
+	leftBound = header->leftBound;
+	rightBound = header->rightBound;
+	topBound = header->topBound;
+
+	// point straight at the mapped pages, nothing is parsed or copied
+	numOfPlatforms = (int)count;
+	platformsInstances = (glm::vec4*)(base + header->instancesOffset);
+	platformsLeft  = (float*)(base + header->leftOffset);
+	platformsRight = (float*)(base + header->rightOffset);
+	platformsLower = (float*)(base + header->lowerOffset);
+	platformsUpper = (float*)(base + header->upperOffset);
+
+	for (uint32_t i = 0; i < header->numOfMovers; i++) {
+		const CompiledMover& mover = compiledMovers[i];
+		if (mover.platform < 0 || mover.platform >= numOfPlatforms) continue;
+		movers.push_back({mover.platform, glm::vec2(mover.baseX, mover.baseY), glm::vec2(mover.offsetX, mover.offsetY), mover.period});
+	}
+
+	return true;
+}
+
+bool Level::SaveCompiled(const char * path) {
+	CompiledLevelHeader header = {};
+	std::memcpy(header.magic, "LVLB", 4);
+	header.version = compiledLevelVersion;
+	header.numOfPlatforms = (uint32_t)numOfPlatforms;
+	header.numOfMovers = (uint32_t)movers.size();
+	header.groundUpperline = groundUpperline;
+	header.spawnX = spawnPoint.x;
+	header.spawnY = spawnPoint.y;
+	header.leftBound = leftBound;
+	header.rightBound = rightBound;
+	header.topBound = topBound;
+
+	// lay out the sections one after another, each aligned
+	uint64_t count = numOfPlatforms;
+	header.instancesOffset = AlignOffset(sizeof(CompiledLevelHeader));
+	header.leftOffset   = AlignOffset(header.instancesOffset + count * sizeof(glm::vec4));
+	header.rightOffset  = AlignOffset(header.leftOffset  + count * sizeof(float));
+	header.lowerOffset  = AlignOffset(header.rightOffset + count * sizeof(float));
+	header.upperOffset  = AlignOffset(header.lowerOffset + count * sizeof(float));
+	header.moversOffset = AlignOffset(header.upperOffset + count * sizeof(float));
+	uint64_t fileSize = header.moversOffset + movers.size() * sizeof(CompiledMover);
+
+	std::vector<unsigned char> file((size_t)fileSize, 0);
+	std::memcpy(&file[0], &header, sizeof(header));
+	if (count > 0) {
+		std::memcpy(&file[(size_t)header.instancesOffset], platformsInstances, (size_t)count * sizeof(glm::vec4));
+		std::memcpy(&file[(size_t)header.leftOffset],  platformsLeft,  (size_t)count * sizeof(float));
+		std::memcpy(&file[(size_t)header.rightOffset], platformsRight, (size_t)count * sizeof(float));
+		std::memcpy(&file[(size_t)header.lowerOffset], platformsLower, (size_t)count * sizeof(float));
+		std::memcpy(&file[(size_t)header.upperOffset], platformsUpper, (size_t)count * sizeof(float));
+	}
+	for (size_t i = 0; i < movers.size(); i++) {
+		const PlatformMover& mover = movers[i];
+		CompiledMover compiled = {mover.platform, mover.basePosition.x, mover.basePosition.y, mover.offset.x, mover.offset.y, mover.period};
+		std::memcpy(&file[(size_t)header.moversOffset + i * sizeof(CompiledMover)], &compiled, sizeof(compiled));
+	}
+
+	std::ofstream fileStream(path, std::ios::binary);
+	fileStream.write((const char*)file.data(), file.size());
+	if (!fileStream) {
+		std::cout << "ERROR::LEVEL::FILE_NOT_SUCCESSFULLY_WRITTEN: " << path << std::endl;
+		return false;
+	}
+	return true;
+}
+
+void Level::Clear() {
+	compiledFile.Release();
+	instancesStorage.clear();
+	leftStorage.clear();
+	rightStorage.clear();
+	lowerStorage.clear();
+	upperStorage.clear();
+	movers.clear();
+	UseStorage();
+}
+
+void Level::Reserve(int count) {
+	instancesStorage.reserve(count);
+	leftStorage.reserve(count);
+	rightStorage.reserve(count);
+	lowerStorage.reserve(count);
+	upperStorage.reserve(count);
+	UseStorage();
+}
+
+
+int Level::NumOfPlatforms() const {return numOfPlatforms;}
+
+int Level::AddPlatform(glm::vec2 center, glm::vec2 size) {
+	if (compiledFile.data != nullptr) DetachFromFile();
+
+	instancesStorage.push_back(glm::vec4(center, size));
+	leftStorage.push_back(center.x - 0.5f * size.x);
+	rightStorage.push_back(center.x + 0.5f * size.x);
+	lowerStorage.push_back(center.y - 0.5f * size.y);
+	upperStorage.push_back(center.y + 0.5f * size.y);
+	UseStorage();
+	return numOfPlatforms - 1;
+}
+
+void Level::MovePlatform(int i, glm::vec2 center) {
+	glm::vec2 size = glm::vec2(platformsInstances[i].z, platformsInstances[i].w);
+	platformsInstances[i] = glm::vec4(center, size);
+	platformsLeft[i]  = center.x - 0.5f * size.x;
+	platformsRight[i] = center.x + 0.5f * size.x;
+	platformsLower[i] = center.y - 0.5f * size.y;
+	platformsUpper[i] = center.y + 0.5f * size.y;
+}
+
+Collider Level::GetCollider(int i) const {
+	return {platformsLeft[i], platformsRight[i], platformsLower[i], platformsUpper[i]};
+}
+
+// Wall to wall, from the ground line up
+Collider Level::Bounds() const {
+	return {leftBound, rightBound, groundUpperline, topBound};
+}
+
+// Platforms overlapping the reach box, in index order (a level has no one-way platforms)
+int Level::QueryColliders(glm::vec2 center, float reach, float /*velocityY*/, Collider * colliders, int maxColliders) const {
+	int count = 0;
+	for (int i = 0; i < numOfPlatforms; i++) {
+		if (center.x + reach < platformsLeft[i] || center.x - reach > platformsRight[i]) continue;
+		if (center.y + reach < platformsLower[i] || center.y - reach > platformsUpper[i]) continue;
+		if (count < maxColliders) colliders[count] = GetCollider(i);
+		count++;
+	}
+	return count;
+}
+
+
+
+// Private Functions:
+
+// Point the public arrays at the owned vectors (they may have reallocated)
+void Level::UseStorage() {
+	numOfPlatforms = (int)instancesStorage.size();
+	platformsInstances = instancesStorage.data();
+	platformsLeft  = leftStorage.data();
+	platformsRight = rightStorage.data();
+	platformsLower = lowerStorage.data();
+	platformsUpper = upperStorage.data();
+}
+
+// Copy a mapped level into owned storage so it can grow
+void Level::DetachFromFile() {
+	instancesStorage.assign(platformsInstances, platformsInstances + numOfPlatforms);
+	leftStorage.assign(platformsLeft, platformsLeft + numOfPlatforms);
+	rightStorage.assign(platformsRight, platformsRight + numOfPlatforms);
+	lowerStorage.assign(platformsLower, platformsLower + numOfPlatforms);
+	upperStorage.assign(platformsUpper, platformsUpper + numOfPlatforms);
+	compiledFile.Release();
+	UseStorage();
+}
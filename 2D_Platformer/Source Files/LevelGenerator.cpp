@@ -0,0 +1,188 @@
+#include <cmath>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+
+#include <GLM/glm.hpp>
+
+#include "LevelGenerator.h"
+#include "NavGraph.h"
+#include "Level.h"
+#include "PlayerPhysics.h"
+
+
+const float gridSteps = 64.0f; // per world unit
+
+// splitmix64: integer only, so every compiler & CPU draws the same sequence
+struct GeneratorRandom {
+	uint64_t state;
+
+	GeneratorRandom(uint64_t seed, int column) : state(seed ^ ((uint64_t)(int64_t)column * 0xD1B54A32D192ED03ull)) {}
+
+	uint64_t Next() {
+		uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	int Between(int low, int high) { // inclusive
+		return low + (int)(Next() % (uint64_t)(high - low + 1));
+	}
+};
+
+static int ToGrid(float value) {return (int)std::floor(value * gridSteps + 0.5f);}
+static float FromGrid(int steps) {return (float)steps / gridSteps;} // exact
+
+
+// Public Functions:
+
+void LevelGenerator::Setup(const Level & level, const PlayerParameters & playerParameters, float tick, const GeneratorSettings & generatorSettings) {
+	parameters = playerParameters;
+	settings = generatorSettings;
+	tickDelta = tick;
+	groundUpperline = level.groundUpperline;
+	topBound = level.topBound;
+
+	float radius = parameters.circleRadius;
+	lowestTop = ToGrid(groundUpperline + settings.platformSize.y + 2.5f * radius); // the circle rolls underneath
+	highestTop = glm::max(ToGrid(topBound - 3.0f * radius), lowestTop); // and stands on top
+	minGap = ToGrid(2.5f * radius); // and fits through
+
+	// The envelope, shrunk by the margin: how high a jump lands, and how far for every height
+	maxRise = glm::max((int)(settings.envelopeMargin * JumpHeight() * gridSteps), 1);
+	maxGap.resize(2 * maxRise + 1);
+	for (int rise = -maxRise; rise <= maxRise; rise++)
+		maxGap[rise + maxRise] = glm::max((int)(settings.envelopeMargin * JumpReach(FromGrid(rise)) * gridSteps), minGap);
+
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	cache.assign(glm::max(settings.cachedColumns, 1), CachedColumn());
+}
+
+void LevelGenerator::Generate(int column, float left, float right, std::vector<glm::vec4> & platforms) const {
+	int start = ToGrid(glm::max(left, settings.startX)), end = ToGrid(right);
+	int width = ToGrid(settings.platformSize.x), height = ToGrid(settings.platformSize.y);
+	if (start >= end) return;
+
+	// A random walk from the ground: each platform within a jump of the previous one
+	GeneratorRandom random(settings.seed, column);
+	std::vector<glm::vec4> placed;
+	int previousTop = ToGrid(groundUpperline);
+	int cursor = start; // right side of the previous platform
+	bool full = false;
+	while (!full) {
+		bool accepted = false;
+		for (int attempt = 0; attempt < settings.maxAttempts && !accepted && !full; attempt++) {
+			int top = random.Between(glm::max(previousTop - maxRise, lowestTop), glm::max(glm::min(previousTop + maxRise, highestTop), lowestTop));
+			int rise = glm::clamp(top - previousTop, -maxRise, maxRise);
+			int platformLeft = cursor + random.Between(minGap, maxGap[rise + maxRise]);
+			if (platformLeft + width > end) {
+				full = true;
+				break;
+			}
+
+			// keep it only if the physics can still get everywhere
+			placed.push_back(glm::vec4(FromGrid(2 * platformLeft + width) * 0.5f, FromGrid(2 * top - height) * 0.5f, settings.platformSize));
+			accepted = AllReachable(placed, left, right);
+			if (accepted) previousTop = top, cursor = platformLeft + width;
+			else placed.pop_back();
+		}
+		if (!accepted) cursor += width; // leave a gap and start over from there
+	}
+	platforms.insert(platforms.end(), placed.begin(), placed.end());
+}
+
+ChunkSource LevelGenerator::Source() const {
+	return [this](glm::ivec2 chunk, const Collider &region, std::vector<glm::vec4> &platforms) {
+		ChunkPlatforms(chunk, region, platforms);
+	};
+}
+
+
+float LevelGenerator::JumpHeight() const {
+	return parameters.kickoff * parameters.kickoff / (2.0f * parameters.gravity);
+}
+
+float LevelGenerator::JumpReach(float rise) const {
+	float falling = glm::max(parameters.kickoff * parameters.kickoff - 2.0f * parameters.gravity * rise, 0.0f);
+	return parameters.velocityX * (parameters.kickoff + std::sqrt(falling)) / parameters.gravity;
+}
+
+
+
+
+// Private Functions:
+
+// The chunk keeps the platforms of its column centered in it; the column is
+// generated by the first worker to ask and shared with the others through the cache
+void LevelGenerator::ChunkPlatforms(glm::ivec2 chunk, const Collider & region, std::vector<glm::vec4> & platforms) const {
+	std::unique_lock<std::mutex> lock(cacheMutex);
+	int entry = -1;
+	while (entry < 0) {
+		int victim = -1;
+		bool generating = false;
+		for (int i = 0; i < (int)cache.size() && entry < 0; i++) {
+			const CachedColumn& cached = cache[i];
+			if (cached.used && cached.column == chunk.x) {
+				if (cached.ready) entry = i;
+				else generating = true;
+			} else if (!cached.used || cached.ready) {
+				if (victim < 0 || !cached.used || (cache[victim].used && cached.lastUse < cache[victim].lastUse)) victim = i;
+			}
+		}
+		if (entry >= 0) break;
+
+		// another worker is on it, or every entry is being generated
+		if (generating || victim < 0) {
+			columnReady.wait(lock);
+			continue;
+		}
+
+		// generate it outside the lock, the entry can't be evicted while not ready
+		CachedColumn& claimed = cache[victim];
+		claimed.column = chunk.x;
+		claimed.used = true;
+		claimed.ready = false;
+		lock.unlock();
+		std::vector<glm::vec4> column;
+		try {
+			Generate(chunk.x, region.leftSide, region.rightSide, column);
+		} catch (...) {
+			// give the entry back, or the workers waiting for this column wait forever
+			lock.lock();
+			claimed.used = false;
+			columnReady.notify_all();
+			throw;
+		}
+		lock.lock();
+		claimed.platforms.swap(column);
+		claimed.ready = true;
+		columnReady.notify_all();
+		entry = victim;
+	}
+
+	CachedColumn& cached = cache[entry];
+	cached.lastUse = ++useCounter;
+	for (const glm::vec4& platform : cached.platforms) {
+		if (platform.y >= region.lowerSide && platform.y < region.upperSide) platforms.push_back(platform);
+	}
+}
+
+// Every platform can be reached from the ground, by the same arc simulation the navigation graph uses
+bool LevelGenerator::AllReachable(const std::vector<glm::vec4> & platforms, float left, float right) const {
+	Level column;
+	column.groundUpperline = groundUpperline;
+	column.topBound = topBound;
+	column.leftBound = left - settings.platformSize.x; // away from the walls, the world has none here
+	column.rightBound = right + settings.platformSize.x;
+	column.Reserve((int)platforms.size());
+	for (const glm::vec4& platform : platforms) column.AddPlatform(glm::vec2(platform), glm::vec2(platform.z, platform.w));
+
+	NavGraph graph;
+	graph.Build(column, parameters, tickDelta);
+	std::vector<int> path;
+	for (int node = 1; node < graph.NumOfNodes(); node++) {
+		if (!graph.FindPath(0, node, path)) return false;
+	}
+	return true;
+}
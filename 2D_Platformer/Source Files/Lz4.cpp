@@ -0,0 +1,142 @@
+#include <cstring>
+#include <cstdint>
+
+#include "Lz4.h"
+
+
+// Format constants (see the LZ4 block format description)
+static const int minMatch = 4;
+static const int lastLiterals = 5;  // the block always ends with at least 5 literals
+static const int matchFindLimit = 12; // the last match must start at least 12 bytes before the end
+static const int maxOffset = 65535;
+static const int hashBits = 12;
+
+
+static uint32_t Read32(const unsigned char* p) {
+	uint32_t value;
+	std::memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+static uint32_t Hash(uint32_t sequence) {return (sequence * 2654435761u) >> (32 - hashBits);}
+
+// Writes a length that didn't fit in its 4 bit token field (runs of 255, then the rest)
+static bool WriteLength(unsigned char*& op, const unsigned char* outputEnd, int length) {
+	for (; length >= 255; length -= 255) {
+		if (op >= outputEnd) return false;
+		*op++ = 255;
+	}
+	if (op >= outputEnd) return false;
+	*op++ = (unsigned char)length;
+	return true;
+}
+
+static bool WriteSequence(unsigned char*& op, const unsigned char* outputEnd, const unsigned char* literals, int literalLength, int offset, int matchLength) {
+	if (op >= outputEnd) return false;
+	unsigned char* token = op++;
+	*token = (unsigned char)((literalLength >= 15 ? 15 : literalLength) << 4);
+	if (literalLength >= 15 && !WriteLength(op, outputEnd, literalLength - 15)) return false;
+
+	if (outputEnd - op < literalLength) return false;
+	std::memcpy(op, literals, literalLength);
+	op += literalLength;
+
+	if (matchLength == 0) return true; // last sequence has no match
+
+	if (outputEnd - op < 2) return false;
+	*op++ = (unsigned char)(offset & 0xFF);
+	*op++ = (unsigned char)(offset >> 8);
+
+	int extraLength = matchLength - minMatch;
+	*token |= (unsigned char)(extraLength >= 15 ? 15 : extraLength);
+	if (extraLength >= 15 && !WriteLength(op, outputEnd, extraLength - 15)) return false;
+	return true;
+}
+
+// Reads the extra bytes of a length whose token field was 15
+static bool ReadLength(const unsigned char*& ip, const unsigned char* inputEnd, int& length) {
+	unsigned char byte;
+	do {
+		if (ip >= inputEnd) return false;
+		byte = *ip++;
+		length += byte;
+	} while (byte == 255);
+	return true;
+}
+
+
+
+int Lz4CompressBound(int inputSize) {return inputSize + inputSize / 255 + 16;}
+
+int Lz4Compress(const unsigned char* input, int inputSize, unsigned char* output, int outputCapacity) {
+	int hashTable[1 << hashBits];
+	for (int i = 0; i < (1 << hashBits); i++) hashTable[i] = -1;
+
+	unsigned char* op = output;
+	const unsigned char* outputEnd = output + outputCapacity;
+	int anchor = 0; // start of the pending literals
+	int ip = 0;
+
+	// greedy matching with a single-entry hash table
+	const int matchLimit = inputSize - lastLiterals;
+	while (ip <= inputSize - matchFindLimit) {
+		uint32_t sequence = Read32(input + ip);
+		uint32_t h = Hash(sequence);
+		int reference = hashTable[h];
+		hashTable[h] = ip;
+
+		if (reference < 0 || ip - reference > maxOffset || Read32(input + reference) != sequence) {
+			ip++;
+			continue;
+		}
+
+		int matchLength = minMatch;
+		while (ip + matchLength < matchLimit && input[reference + matchLength] == input[ip + matchLength]) matchLength++;
+
+		if (!WriteSequence(op, outputEnd, input + anchor, ip - anchor, ip - reference, matchLength)) return -1;
+		ip += matchLength;
+		anchor = ip;
+	}
+
+	// whatever is left goes out as literals
+	if (!WriteSequence(op, outputEnd, input + anchor, inputSize - anchor, 0, 0)) return -1;
+	return (int)(op - output);
+}
+
+int Lz4Decompress(const unsigned char* input, int inputSize, unsigned char* output, int outputSize) {
+	const unsigned char* ip = input;
+	const unsigned char* inputEnd = input + inputSize;
+	unsigned char* op = output;
+	unsigned char* outputEnd = output + outputSize;
+
+	while (ip < inputEnd) {
+		unsigned char token = *ip++;
+
+		// literals
+		int literalLength = token >> 4;
+		if (literalLength == 15 && !ReadLength(ip, inputEnd, literalLength)) return -1;
+		if (inputEnd - ip < literalLength || outputEnd - op < literalLength) return -1;
+		std::memcpy(op, ip, literalLength);
+		ip += literalLength;
+		op += literalLength;
+
+		if (ip == inputEnd) break; // last sequence
+
+		// match
+		if (inputEnd - ip < 2) return -1;
+		int offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if (offset == 0 || offset > op - output) return -1;
+
+		int matchLength = token & 15;
+		if (matchLength == 15 && !ReadLength(ip, inputEnd, matchLength)) return -1;
+		matchLength += minMatch;
+		if (outputEnd - op < matchLength) return -1;
+
+		// byte by byte, the match may overlap the bytes it produces
+		const unsigned char* match = op - offset;
+		for (int i = 0; i < matchLength; i++) *op++ = match[i];
+	}
+
+	return (int)(op - output);
+}
@@ -1,5 +1,9 @@
 #include <string>
 #include <vector>
+#include <memory>
+#include <cstdio>
+#include <chrono>
+#include <cstdint>
 
 #include <GLAD/glad.h>
 #include <GLM/glm.hpp>
@@ -8,98 +12,300 @@
 #include "Text.h"
 #include "Player.h"
 #include "Ground.h"
-#include "Platform.h"
+#include "Level.h"
+#include "PlatformBatch.h"
+#include "ChunkStreamer.h"
+#include "LevelGenerator.h"
+#include "Simulation.h"
+#include "CircleBatch.h"
+#include "ParticleSystem.h"
+#include "GpuParticleSystem.h"
+#include "StaticLayer.h"
+#include "Camera.h"
+#include "FramePacer.h"
+#include "FrameStats.h"
+#include "FrameArena.h"
+#include "AllocationCounter.h"
+#include "FileSystem.h"
 #include "ShaderProgram.h"
+#include "ThreadPool.h"
+#include "AssetLoader.h"
+#include "Profiler.h"
+#include "LatencyProbe.h"
 
 // OpenGL context
 GLFWwindow *window;
 
 // Time variables
-float lastFrame = 0.0f;
-float deltaTime = 0.0f;
+double lastFrame = 0.0; // double: float seconds lose sub-millisecond precision after a few hours
+double deltaTime = 0.0;
+FrameStats frameStats; // every frame's deltaTime, reported on exit or F11
+LatencyProbe latencyProbe; // input-to-photon measurement, toggled with F10
+
+// Transient per-frame data (strings, scratch arrays), released after every swap
+FrameArena frameArena;
 
 // Settings
 unsigned int SCR_WIDTH  = 700;
 unsigned int SCR_HEIGHT = 700;
+const double targetFPS  = 144.0; // 0 = unlimited
+const Vsync_Mode vsyncMode = VSYNC_ADAPTIVE;
+const double ticksPerSecond = 60.0; // physics rate, rendering interpolates between ticks
+const char* levelPath = "Resources/levels/level1.lvl";
+const char* compiledLevelPath = "Resources/levels/level1.lvlb"; // built by AssetCompiler, used when present
+const char* chunkDirectory = "Resources/levels/chunks"; // streamed around the camera, "<x>_<y>.lvl" per chunk, optional
+const bool endlessLevel = true; // generate platforms right of the level instead of reading chunk files
+const uint64_t levelSeed = 2024;
+const float endlessRightBound = 1.0e4f; // hours of running, still fine float precision
+const char* assetPackName = "assets.pak"; // next to the executable, loose files are used when missing
+const char* fontAtlasPath = "Resources/fonts/arial36.fnta"; // baked by AssetCompiler from arial.ttf
+const double uploadBudgetMs = 4.0; // GL upload time per frame while assets stream in
+const char* tracePath = "trace.json"; // written on F12 in profiling builds
+const unsigned int traceFrames = 300;
+const char* frameStatsPath = "frame_stats.json"; // written on exit for the perf dashboards
+const size_t frameArenaSize = 16 * 1024;
+const unsigned int allocationWarmupFrames = 120; // containers & the arena settle their capacity first
+const unsigned int allocationCheckFrames = 600; // steady-state frames run by --check-allocations
+const glm::vec2 cameraViewSize = glm::vec2(2.0f, 2.0f); // world units on screen, the whole of a one-screen level
 
 // Functions
 void InitGLAD();
 void InitGLFW();
-std::string FormatTime(int timeNow);
-void ProcessKeyboardInput(Player &player);
+void FormatTime(int seconds, char* text, size_t size);
+void KeyCallback(GLFWwindow* eventWindow, int key, int scancode, int action, int mods);
+void LoadAssets(AssetLoader &loader, Ground &ground, Text &timerText);
+bool ShowLoadingScreen(AssetLoader &loader, FramePacer &framePacer);
 
 
 // Player
 Player player;
+CircleBatch circleBatch;
 const float circleRadius = 0.07f;
-const int numOfCircleVertices = 20;
-float circleVertices[(numOfCircleVertices + 1) * 3];
-void CalculatePlayerData();
+
+// Effects
+ParticleSystem particleSystem;
+const int landingDust = 24, hyperLandingDebris = 40; // particles per landing
+const float hyperTrailRate = 120.0f; // particles per second while hyper
+GpuParticleSystem sparks; // too many for the CPU pools, simulated on the GPU
+const ParticleMaterial sparkMaterial = {glm::vec4(1.0f, 0.6f, 0.2f, 0.8f), glm::vec2(-1.5f, 0.2f), glm::vec2(1.5f, 2.0f), 0.4f, 1.0f, 0.004f, 0.01f, 3.0f, 1.0f};
+const int hyperLandingSparks = 20000;
 
 
 // Ground
 unsigned int rectangleIndices[6];
 float groundVertices[4 * 3]; // 4 points, 3 coordinates each
+const float groundDepth = 0.2f; // below the ground line, also the lowest the camera looks
 void CalculateGroundData();
 
 
-// Platforms
-const int numOfPlatforms = 4;
-float platformsVertices[4 * 3]; // 4 points, 3 coordinates each
-glm::vec3 platformsPositions[numOfPlatforms];
-void CalculatePlatformsData();
+// Level (ground height, spawn point & platforms)
+Level level;
+PlatformBatch platformBatch;
+ChunkStreamer chunkStreamer; // platforms beyond the level's own, loaded as the camera gets near
+LevelGenerator levelGenerator;
+float generatedFrom; // the level's own right wall, where endless platforms start
 
 
 
-int main () {
+int main (int argc, char* argv[]) {
+	// --check-allocations: stand still for a while, fail if any steady-state frame touched the heap
+	bool checkAllocations = argc > 1 && std::string(argv[1]) == "--check-allocations";
+	if (checkAllocations && !AllocationCounter::Enabled()) {
+		std::cout << "ERROR::ALLOCATION_CHECK::NOT_COUNTING: build with PLATFORMER_COUNT_ALLOCATIONS (Debug)" << std::endl;
+		return 1;
+	}
+
 	InitGLFW(); // Create opengl context
 	if (window == NULL) return -1;
 
 	InitGLAD(); // Get function pointers from GPU drivers
 
-	
-	CalculatePlayerData();
-	player.Setup(numOfCircleVertices, circleVertices, "Shaders/circleShader.vs", "Shaders/circleShader.fs", circleRadius);
+	// Assets come from the pack next to the executable, wherever the working directory is
+	if (!FileSystem::Mount((FileSystem::ExecutableDirectory() + assetPackName).c_str()))
+		std::cout << "No asset pack found, reading loose files" << std::endl;
+
+	FramePacer framePacer;
+	framePacer.Setup(targetFPS, vsyncMode);
+
+	// Files are read on the workers while the window is already up, GL objects are created a few per frame
+	ThreadPool workerPool;
+	workerPool.Setup();
+	AssetLoader loader;
+	loader.Setup(&workerPool, uploadBudgetMs);
+
+	Ground ground;
+	Text timerText;
+	LoadAssets(loader, ground, timerText);
+	if (!ShowLoadingScreen(loader, framePacer)) {
+		workerPool.Shutdown(); // workers may still be writing into the level
+		FileSystem::Unmount();
+		glfwTerminate();
+		return -1;
+	}
 
-	CalculateGroundData();
-	Ground ground(groundVertices, rectangleIndices, "Shaders/groundShader.vs", "Shaders/groundShader.fs");
+	// The camera follows the player across the level, never showing past its walls, ceiling or under the ground
+	int framebufferWidth, framebufferHeight;
+	glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+	Camera camera;
+	camera.Setup(cameraViewSize, framebufferWidth, framebufferHeight);
+	camera.SetBounds({level.leftBound, level.rightBound, level.groundUpperline - groundDepth, level.topBound});
+	camera.SetPosition(level.spawnPoint);
+
+	// Ground & platforms rarely move, so they are rendered around the view once and blitted every frame
+	StaticLayer staticLayer;
+	staticLayer.Setup(framebufferWidth, framebufferHeight);
+
+	// Physics runs on its own thread from here on, this thread only handles events & rendering
+	Simulation simulation;
+	if (endlessLevel) {
+		GeneratorSettings generatorSettings;
+		generatorSettings.seed = levelSeed;
+		generatorSettings.startX = generatedFrom;
+		levelGenerator.Setup(level, PlayerPhysics::Parameters(circleRadius, level), (float)(1.0 / ticksPerSecond), generatorSettings);
+	}
+	chunkStreamer.Start(&workerPool, &level, endlessLevel ? levelGenerator.Source() : ChunkStreamer::LevelFiles(chunkDirectory));
+	simulation.Setup(&player, &level, ticksPerSecond, &chunkStreamer);
+	simulation.Start();
 
-	CalculatePlatformsData();
-	std::vector<Platform> platforms;
-	for (int i = 0; i < numOfPlatforms; i++) 
-		platforms.push_back(Platform(platformsVertices, rectangleIndices, "Shaders/platformsShader.vs", "Shaders/platformsShader.fs"));
+	// Input reaches the simulation as timestamped events instead of once-per-frame polling
+	glfwSetWindowUserPointer(window, &simulation);
+	glfwSetKeyCallback(window, KeyCallback);
 
 
-	Text timerText(0, 36, "Shaders/fontShader.vs", "Shaders/fontShader.fs", SCR_WIDTH, SCR_HEIGHT);
+	unsigned int landingsSeen = 0;
+	float trailDue = 0.0f; // fraction of a trail particle carried to the next frame
 
+	frameArena.Setup(frameArenaSize);
+	unsigned long long frameNumber = 0, framesWithAllocations = 0;
+	uint64_t allocationsBefore = AllocationCounter::ThreadAllocations();
 
+	std::chrono::steady_clock::time_point previousPoll = std::chrono::steady_clock::now();
+
+	PROFILE_THREAD_NAME("Main");
+	lastFrame = glfwGetTime(); // loading time isn't a frame
 	while (!glfwWindowShouldClose(window)) {
+		PROFILE_FRAME();
+		PROFILE_SCOPE("Frame");
+
 		// Update time variables
-		float crntFrame = (float)glfwGetTime();
+		double crntFrame = glfwGetTime();
 		deltaTime = crntFrame - lastFrame;
 		lastFrame = crntFrame;
-
-		// Render background
-		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT);
-
-		// Render objects
-		ground.Draw();
-		for (int i = 0; i < numOfPlatforms; i++) platforms[i].Draw(platformsPositions[i]);
-		player.Draw(deltaTime, numOfPlatforms, platforms);
+		frameStats.Record(deltaTime);
+
+		// Deliver pending key events to the simulation's input queue
+		{
+			PROFILE_SCOPE("PollEvents");
+			glfwPollEvents(); // check for triggered events, update window state, call callback functions
+			latencyProbe.Inject(simulation, previousPoll);
+			previousPoll = std::chrono::steady_clock::now();
+		}
+
+		// Latest published world state, never blocks the simulation
+		const WorldSnapshot& world = simulation.LatestSnapshot();
+		float alpha = simulation.InterpolationAlpha(world);
+
+		// Moving platforms invalidate the static layer
+		if (!world.movingPlatforms.empty()) {
+			for (const MovingPlatform& moving : world.movingPlatforms) platformBatch.UpdateInstance(moving.platform, moving.Instance(alpha));
+			staticLayer.Invalidate();
+		}
+
+		glm::vec2 playerPosition = world.PlayerPosition(alpha);
+		glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+		camera.Resize(framebufferWidth, framebufferHeight);
+		camera.Follow(playerPosition, (float)deltaTime);
+		glm::vec4 viewRegion = camera.ViewRegion();
+		if (chunkStreamer.Update(camera.GetPosition())) staticLayer.Invalidate();
+		staticLayer.Update(framebufferWidth, framebufferHeight, viewRegion);
+
+		// Render background & static objects (only when the cache is stale or the view left it)
+		if (staticLayer.IsDirty()) {
+			PROFILE_SCOPE("StaticLayer::Capture");
+			glm::vec4 cachedRegion = staticLayer.CachedRegion();
+			glm::mat4 cachedViewProjection = Camera::ViewProjection(cachedRegion);
+			staticLayer.BeginCapture();
+			glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+			glClear(GL_COLOR_BUFFER_BIT);
+
+			ground.Draw(cachedViewProjection);
+			platformBatch.Draw(cachedRegion, cachedViewProjection);
+			chunkStreamer.Draw(cachedRegion, cachedViewProjection);
+			staticLayer.EndCapture();
+		}
+		staticLayer.Composite(viewRegion);
+
+		// Effects follow the player: dust (and debris when hyper) on landing, a trail while hyper
+		if (world.landings != landingsSeen) {
+			glm::vec2 feet = world.playerPosition - glm::vec2(0.0f, circleRadius);
+			particleSystem.Emit(PARTICLE_DUST, feet, landingDust);
+			if (world.hyper) {
+				particleSystem.Emit(PARTICLE_DEBRIS, feet, hyperLandingDebris);
+				sparks.Emit(feet, hyperLandingSparks);
+			}
+			landingsSeen = world.landings;
+		}
+		trailDue = world.hyper ? trailDue + hyperTrailRate * (float)deltaTime : 0.0f;
+		particleSystem.Emit(PARTICLE_TRAIL, playerPosition, (int)trailDue);
+		trailDue -= (float)(int)trailDue;
+		particleSystem.Update((float)deltaTime);
+		sparks.Update((float)deltaTime);
+
+		// Render dynamic objects
+		particleSystem.Draw(Camera::ViewProjection(viewRegion));
+		sparks.Draw(Camera::ViewProjection(viewRegion));
+		if (camera.IsVisible({playerPosition.x - circleRadius, playerPosition.x + circleRadius, playerPosition.y - circleRadius, playerPosition.y + circleRadius})) {
+			circleBatch.Add(playerPosition, circleRadius);
+			circleBatch.Draw(world.hyper, Camera::ViewProjection(viewRegion));
+		}
 
 		int timeNow = (int)round(glfwGetTime());
-		timerText.RenderText(FormatTime(timeNow), 550.0f, 650.0f, 1.0f, glm::vec3(1.0f, 1.0f, 1.0f));
-		
-		ProcessKeyboardInput(player);
+		char timeText[16];
+		FormatTime(timeNow, timeText, sizeof(timeText));
+		timerText.RenderText(timeText, 550.0f, 650.0f, 1.0f, glm::vec3(1.0f, 1.0f, 1.0f));
+
+		framePacer.WaitForNextFrame(); // sleep off the rest of the frame instead of spinning
+		PROFILE_SCOPE("SwapBuffers");
+		if (latencyProbe.IsEnabled()) latencyProbe.FrameSubmitted(world);
 		glfwSwapBuffers(window); // swap the two buffers (front & back)
-		glfwPollEvents(); // check for triggered events, update window state, call callback functions
+		if (latencyProbe.IsEnabled()) latencyProbe.FrameSwapped(), latencyProbe.Collect();
+		frameArena.Reset();
+
+		// Steady-state frames must not touch the heap (counted in Debug builds only)
+		uint64_t allocationsAfter = AllocationCounter::ThreadAllocations();
+		if (++frameNumber > allocationWarmupFrames && allocationsAfter != allocationsBefore) {
+			if (checkAllocations)
+				std::cout << "ERROR::FRAME::HEAP_ALLOCATIONS: " << allocationsAfter - allocationsBefore << " in frame " << frameNumber << std::endl;
+			else if (framesWithAllocations == 0)
+				std::cout << "WARNING::FRAME::HEAP_ALLOCATIONS: " << allocationsAfter - allocationsBefore << " in frame " << frameNumber << std::endl;
+			framesWithAllocations++;
+		}
+		allocationsBefore = allocationsAfter;
+		if (checkAllocations && frameNumber == allocationWarmupFrames + allocationCheckFrames) glfwSetWindowShouldClose(window, GLFW_TRUE);
 	}
 
-	player.DeleteVAO();
+	glfwSetKeyCallback(window, NULL);
+	glfwSetWindowUserPointer(window, NULL);
+	simulation.Stop();
+	workerPool.Shutdown();
+	circleBatch.DeleteVAO();
+	particleSystem.DeleteVAO();
+	sparks.DeleteVAO();
+	platformBatch.DeleteVAO();
+	chunkStreamer.Delete();
 	ground.DeleteVAO();
+	timerText.Delete();
+	staticLayer.Delete();
+	framePacer.PrintReport();
+	latencyProbe.SetEnabled(false); // prints its report if it was running
+	frameStats.PrintReport();
+	frameStats.WriteJson(frameStatsPath);
+	if (AllocationCounter::Enabled()) std::cout << "Frames with heap allocations: " << framesWithAllocations << std::endl;
+	frameArena.Shutdown();
+	framePacer.Shutdown();
+	FileSystem::Unmount();
 	glfwTerminate();
-	return 0;
+	return checkAllocations && framesWithAllocations > 0 ? 1 : 0;
 }
 
 
@@ -129,56 +335,135 @@ void InitGLAD() {
 		std::cout << "Failed to initialize GLAD" << std::endl;
 }
 
-void ProcessKeyboardInput(Player &player) {
-	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-		glfwSetWindowShouldClose(window, true); // close window when esc is pressed
+// Key events, delivered by glfwPollEvents. Gameplay keys are stamped and queued
+// for the simulation, which applies each one in the tick it happened in.
+void KeyCallback(GLFWwindow* eventWindow, int key, int, int action, int) {
+	if (action == GLFW_REPEAT) return;
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	bool pressed = action == GLFW_PRESS;
+
+	if (pressed && key == GLFW_KEY_ESCAPE) glfwSetWindowShouldClose(eventWindow, true); // close window when esc is pressed
+	if (pressed && key == GLFW_KEY_F10) latencyProbe.SetEnabled(!latencyProbe.IsEnabled()); // report printed when turned off
+	if (pressed && key == GLFW_KEY_F11) frameStats.PrintReport(); // frame time report so far
+	if (pressed && key == GLFW_KEY_F12) PROFILE_WRITE_TRACE(tracePath, traceFrames); // profiling builds only
+
+	unsigned int inputBit = 0;
+	switch (key) {
+		case GLFW_KEY_UP:         inputBit = INPUT_UP;    break; // jump
+		case GLFW_KEY_RIGHT:      inputBit = INPUT_RIGHT; break; // move right
+		case GLFW_KEY_LEFT:       inputBit = INPUT_LEFT;  break; // move left
+		case GLFW_KEY_LEFT_SHIFT: inputBit = INPUT_HYPER; break;
+	}
 
-	if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS) // jump
-		player.Move(UP, deltaTime);
-	if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS) // move right
-		player.Move(RIGHT, deltaTime);
-	if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS) // move left
-		player.Move(LEFT, deltaTime);
+	Simulation* simulation = (Simulation*)glfwGetWindowUserPointer(eventWindow);
+	if (inputBit != 0 && simulation != nullptr) simulation->QueueInput(inputBit, pressed, now);
+}
 
 
-	glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) ? player.GetHyper() : player.BeNormal();
+// Queues every asset the game needs. Level parsing & shader and font reads
+// happen on the workers; each lambda stages the GL work that has to follow on this thread.
+void LoadAssets(AssetLoader &loader, Ground &ground, Text &timerText) {
+	loader.Load("level", [&ground](AssetUploads &uploads) {
+		if (!level.LoadCompiled(compiledLevelPath) && !level.Load(levelPath)) return false;
+		if (endlessLevel) generatedFrom = level.rightBound, level.rightBound = endlessRightBound;
+
+		ShaderSources groundShader, platformsShader;
+		if (!ShaderProgram::ReadSources("Shaders/groundShader.vs", "Shaders/groundShader.fs", nullptr, groundShader)) return false;
+		if (!ShaderProgram::ReadSources("Shaders/platformsShader.vs", "Shaders/platformsShader.fs", nullptr, platformsShader)) return false;
+
+		uploads.Stage([&ground, groundShader] {
+			player.Setup(circleRadius, level);
+			CalculateGroundData();
+			ground.Setup(groundVertices, rectangleIndices, groundShader);
+		});
+		uploads.Stage([platformsShader] {
+			platformBatch.Setup(platformsShader);
+			platformBatch.Upload(level);
+			chunkStreamer.Setup(platformsShader);
+		});
+		return true;
+	});
+
+	loader.Load("player", [](AssetUploads &uploads) {
+		ShaderSources circleShader;
+		if (!ShaderProgram::ReadSources("Shaders/circleShader.vs", "Shaders/circleShader.fs", nullptr, circleShader)) return false;
+
+		ShaderSources particleShader;
+		if (!ShaderProgram::ReadSources("Shaders/particleShader.vs", "Shaders/particleShader.fs", nullptr, particleShader)) return false;
+
+		uploads.Stage([circleShader] {circleBatch.Setup(circleShader);});
+		ShaderSources sparkUpdateShader, sparkShader;
+		if (!ShaderProgram::ReadSources("Shaders/particleUpdate.vs", nullptr, nullptr, sparkUpdateShader)) return false;
+		if (!ShaderProgram::ReadSources("Shaders/gpuParticleShader.vs", "Shaders/particleShader.fs", nullptr, sparkShader)) return false;
+
+		uploads.Stage([particleShader] {particleSystem.Setup(particleShader);});
+		uploads.Stage([sparkUpdateShader, sparkShader] {sparks.Setup(sparkUpdateShader, sparkShader, sparkMaterial);});
+		return true;
+	});
+
+	loader.Load("font", [&timerText](AssetUploads &uploads) {
+		ShaderSources fontShader;
+		std::shared_ptr<FontAtlas> atlas = std::make_shared<FontAtlas>();
+		if (!ShaderProgram::ReadSources("Shaders/fontShader.vs", "Shaders/fontShader.fs", nullptr, fontShader)) return false;
+		if (!atlas->Load(fontAtlasPath)) return false;
+
+		uploads.Stage([&timerText, fontShader] {timerText.Setup(fontShader, SCR_WIDTH, SCR_HEIGHT);});
+		uploads.Stage([&timerText, atlas] {timerText.UploadAtlas(*atlas);});
+		return true;
+	});
 }
 
+// Draws a progress bar until every asset is loaded. Uses scissored clears only,
+// so it works before any shader exists. Returns false if loading failed or the window was closed.
+bool ShowLoadingScreen(AssetLoader &loader, FramePacer &framePacer) {
+	double loadStart = glfwGetTime();
+
+	while (!loader.IsDone()) {
+		glfwPollEvents();
+		if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) glfwSetWindowShouldClose(window, true);
+		if (glfwWindowShouldClose(window)) return false;
+
+		loader.Update();
+
+		int framebufferWidth, framebufferHeight;
+		glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
 
-void CalculatePlayerData() {
-	float deg = 0.0f;
+		int barWidth = framebufferWidth / 2, barHeight = framebufferHeight / 50 + 1;
+		glEnable(GL_SCISSOR_TEST);
+		glScissor(framebufferWidth / 4, framebufferHeight / 2, (int)(barWidth * loader.Progress()), barHeight);
+		glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		glDisable(GL_SCISSOR_TEST);
 
-	// points on circumference
-	for (int idx = 0; idx < 3 * numOfCircleVertices; idx += 3, deg += 360.0f / numOfCircleVertices) {
-		circleVertices[idx + 0] = (circleRadius * (float)std::cos(glm::radians(deg))); // x coordinate
-		circleVertices[idx + 1] = (circleRadius * (float)std::sin(glm::radians(deg))); // y coordinate
-		circleVertices[idx + 2] = 0.0f; // z coordinate
+		framePacer.WaitForNextFrame();
+		glfwSwapBuffers(window);
 	}
 
-	// center of circle
-	circleVertices[3 * numOfCircleVertices + 0] = 0.0f;
-	circleVertices[3 * numOfCircleVertices + 1] = 0.0f;
-	circleVertices[3 * numOfCircleVertices + 2] = 0.0f;
+	if (loader.Failed()) return false;
+	std::cout << "Assets loaded in " << (int)((glfwGetTime() - loadStart) * 1000.0) << " ms" << std::endl;
+	return true;
 }
 
 
 void CalculateGroundData() {
-	// Position data:
+	// Position data (wall to wall, in world units):
 	// lower left
-	groundVertices[0] = -1.0f;
-	groundVertices[1] = -1.0f;
+	groundVertices[0] = level.leftBound;
+	groundVertices[1] = level.groundUpperline - groundDepth;
 	groundVertices[2] =  0.0f;
 	// lower right
-	groundVertices[3] =  1.0f;
-	groundVertices[4] = -1.0f;
+	groundVertices[3] = level.rightBound;
+	groundVertices[4] = level.groundUpperline - groundDepth;
 	groundVertices[5] =  0.0f;
 	// upper right
-	groundVertices[6] =  1.0f;
-	groundVertices[7] = -0.8f;
+	groundVertices[6] = level.rightBound;
+	groundVertices[7] = level.groundUpperline;
 	groundVertices[8] =  0.0f;
 	// upper left
-	groundVertices[9] = -1.0f;
-	groundVertices[10] = -0.8f;
+	groundVertices[9] = level.leftBound;
+	groundVertices[10] = level.groundUpperline;
 	groundVertices[11] =  0.0f;
 
 
@@ -195,41 +480,10 @@ void CalculateGroundData() {
 
 
 
-void CalculatePlatformsData() {
-	// Position data:
-	// first vertex
-	platformsVertices[0] = -0.25f;
-	platformsVertices[1] =  -0.08f;
-	platformsVertices[2] =   0.0f;
-    // second vertex
-	platformsVertices[3] = 0.25f;
-	platformsVertices[4] = -0.08f;
-	platformsVertices[5] =  0.0f;
-	// third vertex
-	platformsVertices[6] = 0.25f;
-	platformsVertices[7] =  0.08f;
-	platformsVertices[8] =  0.0f;
-	// fourth vertex
-	platformsVertices[9] = -0.25f;
-	platformsVertices[10] =  0.08f;
-	platformsVertices[11] =  0.0f;
-
-
-	// translation vectors
-	platformsPositions[0] = glm::vec3(0.75f, -0.5f, 0.0f);
-	platformsPositions[1] = glm::vec3(0.0f, -0.25f, 0.0f);
-	platformsPositions[2] = glm::vec3(-0.75f, 0.175f, 0.0f);
-	platformsPositions[3] = glm::vec3(0.0f, 0.45f, 0.0f);
-}
-
-
-std::string FormatTime(int seconds) {
+// hh:mm:ss into a caller buffer (no heap allocation)
+void FormatTime(int seconds, char* text, size_t size) {
 	int hours = seconds / 3600; seconds %= 3600;
 	int minutes = seconds / 60; seconds %= 60;
 
-	std::string time;
-	time += (hours < 10 ? "0" : "") + std::to_string(hours) + ":";
-	time += (minutes < 10 ? "0" : "") + std::to_string(minutes) + ":";
-	time += (seconds < 10 ? "0" : "") + std::to_string(seconds);
-	return time;
+	snprintf(text, size, "%02d:%02d:%02d", hours, minutes, seconds);
 }
\ No newline at end of file
@@ -0,0 +1,84 @@
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "MappedFile.h"
+
+
+// Destructor
+MappedFile::~MappedFile() {Close();}
+
+
+// Public Functions:
+
+bool MappedFile::Open(const char * path, bool copyOnWrite) {
+	Close();
+
+#ifdef _WIN32
+	fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (fileHandle == INVALID_HANDLE_VALUE) {
+		fileHandle = nullptr;
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+		Close();
+		return false;
+	}
+	size = (size_t)fileSize.QuadPart;
+
+	mappingHandle = CreateFileMappingA(fileHandle, NULL, copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, NULL);
+	if (mappingHandle == NULL) {
+		mappingHandle = nullptr;
+		Close();
+		return false;
+	}
+
+	data = (unsigned char*)MapViewOfFile(mappingHandle, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+#else
+	int fileDescriptor = open(path, O_RDONLY);
+	if (fileDescriptor < 0) return false;
+
+	struct stat fileStatus;
+	if (fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size == 0) {
+		close(fileDescriptor);
+		return false;
+	}
+	size = (size_t)fileStatus.st_size;
+
+	void* view = mmap(NULL, size, copyOnWrite ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	close(fileDescriptor); // the mapping keeps its own reference
+	data = (view == MAP_FAILED) ? nullptr : (unsigned char*)view;
+#endif
+
+	if (data == nullptr) {
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+	if (data != nullptr) UnmapViewOfFile(data);
+	if (mappingHandle != nullptr) CloseHandle(mappingHandle);
+	if (fileHandle != nullptr) CloseHandle(fileHandle);
+	mappingHandle = fileHandle = nullptr;
+#else
+	if (data != nullptr) munmap(data, size);
+#endif
+	data = nullptr;
+	size = 0;
+}
+
+bool MappedFile::IsOpen() {return data != nullptr;}
+unsigned char* MappedFile::Data() {return data;}
+size_t MappedFile::Size() {return size;}
@@ -0,0 +1,399 @@
+#include <queue>
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <functional>
+
+#include <GLM/glm.hpp>
+
+#include "NavGraph.h"
+#include "PlayerPhysics.h"
+#include "FileSystem.h"
+#include "Level.h"
+#include "Profiler.h"
+
+
+// Arcs still in the air after this long are given up on
+static const float maxArcTime = 4.0f;
+// Ticks a player placed on a surface gets to come to rest before launching
+static const int settleTicks = 30;
+// Cached paths kept before the cache starts over
+static const size_t maxCachedPaths = 4096;
+
+// Inputs tried from every launch point
+static const unsigned int jumpInputs[] = {
+	INPUT_UP, INPUT_UP | INPUT_RIGHT, INPUT_UP | INPUT_LEFT,
+	INPUT_UP | INPUT_HYPER, INPUT_UP | INPUT_RIGHT | INPUT_HYPER, INPUT_UP | INPUT_LEFT | INPUT_HYPER,
+};
+static const unsigned int leftFallInputs[] = {INPUT_LEFT, INPUT_LEFT | INPUT_HYPER};
+static const unsigned int rightFallInputs[] = {INPUT_RIGHT, INPUT_RIGHT | INPUT_HYPER};
+
+static uint64_t AlignOffset(uint64_t offset) {
+	return (offset + 63) / 64 * 64;
+}
+
+static void Expand(Collider &box, glm::vec2 position, float radius) {
+	box.leftSide  = glm::min(box.leftSide,  position.x - radius);
+	box.rightSide = glm::max(box.rightSide, position.x + radius);
+	box.lowerSide = glm::min(box.lowerSide, position.y - radius);
+	box.upperSide = glm::max(box.upperSide, position.y + radius);
+}
+
+static bool Overlap(const Collider &a, const Collider &b) {
+	return a.leftSide <= b.rightSide && b.leftSide <= a.rightSide && a.lowerSide <= b.upperSide && b.lowerSide <= a.upperSide;
+}
+
+
+// Public Functions:
+
+void NavGraph::Build(const Level & level, const PlayerParameters & playerParameters, float tick, ThreadPool * pool) {
+	PROFILE_SCOPE("NavGraph::Build");
+	parameters = playerParameters;
+	tickDelta = tick;
+	nodes.clear();
+	nodeLinks.clear();
+	UpdateNodes(level);
+
+	std::vector<int> allNodes(nodes.size());
+	for (size_t i = 0; i < nodes.size(); i++) allNodes[i] = (int)i;
+	SimulateNodes(level, allNodes, pool);
+	FlattenLinks();
+}
+
+// Only nodes whose arcs could be affected are simulated again: new ones, and
+// those whose surface or earlier arcs touch the changed region.
+// Removing platforms shifts the indices every untouched link points at, so then
+// the whole graph is built again.
+void NavGraph::Rebuild(const Level & level, const Collider & changedRegion, ThreadPool * pool) {
+	PROFILE_SCOPE("NavGraph::Rebuild");
+	size_t oldNumOfNodes = nodes.size();
+	if ((size_t)level.NumOfPlatforms() + 1 < oldNumOfNodes) {
+		Build(level, parameters, tickDelta, pool);
+		return;
+	}
+	UpdateNodes(level);
+
+	std::vector<int> dirtyNodes;
+	for (size_t i = 0; i < nodes.size(); i++) {
+		const NavNode& node = nodes[i];
+		Collider surface = {node.left, node.right, node.height, node.height};
+		if (i >= oldNumOfNodes || Overlap(node.sweep, changedRegion) || Overlap(surface, changedRegion)) dirtyNodes.push_back((int)i);
+	}
+	SimulateNodes(level, dirtyNodes, pool);
+	FlattenLinks();
+}
+
+bool NavGraph::Load(const char * path, const PlayerParameters & playerParameters) {
+	FileData file;
+	if (!FileSystem::ReadFile(path, file)) {
+		std::cout << "ERROR::NAV_GRAPH::FILE_NOT_SUCCESSFULLY_READ: " << path << std::endl;
+		return false;
+	}
+
+	// Validate before trusting any offset
+	const CompiledNavHeader* header = (const CompiledNavHeader*)file.data;
+	if (file.size < sizeof(CompiledNavHeader) || std::memcmp(header->magic, "NAVB", 4) != 0 || header->version != compiledNavVersion) {
+		std::cout << "ERROR::NAV_GRAPH::INVALID_FILE: " << path << std::endl;
+		return false;
+	}
+	if (!SectionInside(header->nodesOffset, header->numOfNodes, sizeof(NavNode), file.size)
+		|| !SectionInside(header->linksOffset, header->numOfLinks, sizeof(NavLink), file.size)) {
+		std::cout << "ERROR::NAV_GRAPH::TRUNCATED_FILE: " << path << std::endl;
+		return false;
+	}
+	if (header->circleRadius != playerParameters.circleRadius) {
+		std::cout << "ERROR::NAV_GRAPH::BUILT_FOR_ANOTHER_PLAYER: " << path << std::endl;
+		return false;
+	}
+
+	parameters = playerParameters;
+	tickDelta = header->tickDelta;
+	const NavNode* fileNodes = (const NavNode*)(file.data + header->nodesOffset);
+	const NavLink* fileLinks = (const NavLink*)(file.data + header->linksOffset);
+	nodes.assign(fileNodes, fileNodes + header->numOfNodes);
+
+	// split back into per node lists so the graph can be rebuilt incrementally
+	nodeLinks.assign(nodes.size(), std::vector<NavLink>());
+	for (uint32_t i = 0; i < header->numOfLinks; i++) {
+		const NavLink& link = fileLinks[i];
+		if (link.from < 0 || link.from >= (int32_t)nodes.size() || link.to < 0 || link.to >= (int32_t)nodes.size()) {
+			std::cout << "ERROR::NAV_GRAPH::INVALID_FILE: " << path << std::endl;
+			nodes.clear();
+			nodeLinks.clear();
+			return false;
+		}
+		nodeLinks[link.from].push_back(link);
+	}
+	FlattenLinks();
+	return true;
+}
+
+bool NavGraph::Save(const char * path) const {
+	CompiledNavHeader header = {};
+	std::memcpy(header.magic, "NAVB", 4);
+	header.version = compiledNavVersion;
+	header.numOfNodes = (uint32_t)nodes.size();
+	header.numOfLinks = (uint32_t)links.size();
+	header.circleRadius = parameters.circleRadius;
+	header.tickDelta = tickDelta;
+	header.nodesOffset = AlignOffset(sizeof(CompiledNavHeader));
+	header.linksOffset = AlignOffset(header.nodesOffset + nodes.size() * sizeof(NavNode));
+	uint64_t fileSize = header.linksOffset + links.size() * sizeof(NavLink);
+
+	std::vector<unsigned char> file((size_t)fileSize, 0);
+	std::memcpy(&file[0], &header, sizeof(header));
+	if (!nodes.empty()) std::memcpy(&file[(size_t)header.nodesOffset], nodes.data(), nodes.size() * sizeof(NavNode));
+	if (!links.empty()) std::memcpy(&file[(size_t)header.linksOffset], links.data(), links.size() * sizeof(NavLink));
+
+	std::ofstream fileStream(path, std::ios::binary);
+	fileStream.write((const char*)file.data(), file.size());
+	if (!fileStream) {
+		std::cout << "ERROR::NAV_GRAPH::FILE_NOT_SUCCESSFULLY_WRITTEN: " << path << std::endl;
+		return false;
+	}
+	return true;
+}
+
+
+int NavGraph::NodeAt(glm::vec2 position) const {
+	float radius = parameters.circleRadius;
+	if (position.y <= parameters.lowestPoint) return 0;
+
+	// the surface right under the circle; corners hold it up to half a radius past the edge
+	int best = -1;
+	float bestError = 0.5f * radius;
+	for (size_t i = 1; i < nodes.size(); i++) {
+		const NavNode& node = nodes[i];
+		if (position.x < node.left - 0.5f * radius || position.x > node.right + 0.5f * radius) continue;
+
+		float error = glm::abs(position.y - (node.height + radius));
+		if (error < bestError) best = (int)i, bestError = error;
+	}
+	return best;
+}
+
+bool NavGraph::FindPath(int from, int to, std::vector<int> & path) const {
+	path.clear();
+	if (from < 0 || to < 0 || from >= (int)nodes.size() || to >= (int)nodes.size()) return false;
+	if (from == to) return true;
+
+	uint64_t key = ((uint64_t)from << 32) | (uint32_t)to;
+	{
+		std::lock_guard<std::mutex> lock(cacheMutex);
+		std::unordered_map<uint64_t, CachedPath>::const_iterator cached = pathCache.find(key);
+		if (cached != pathCache.end()) {
+			path = cached->second.links;
+			return cached->second.found;
+		}
+	}
+
+	// search outside the lock, two threads racing on the same pair just find the same path
+	bool found = Search(from, to, path);
+
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	if (pathCache.size() >= maxCachedPaths) pathCache.clear();
+	pathCache[key] = {found, path};
+	return found;
+}
+
+
+
+
+// Private Functions:
+
+// Node i + 1 is the top of platform i, node 0 the ground
+void NavGraph::UpdateNodes(const Level & level) {
+	size_t numOfNodes = (size_t)level.NumOfPlatforms() + 1;
+	NavNode empty = {0.0f, 0.0f, 0.0f, 0, 0, {FLT_MAX, -FLT_MAX, FLT_MAX, -FLT_MAX}};
+	nodes.resize(numOfNodes, empty);
+	nodeLinks.resize(numOfNodes);
+	Collider bounds = level.Bounds();
+	parameters.lowestPoint = bounds.lowerSide + parameters.circleRadius;
+	parameters.highestPoint = bounds.upperSide - parameters.circleRadius;
+	parameters.leftmostPosition = bounds.leftSide + parameters.circleRadius;
+	parameters.rightmostPosition = bounds.rightSide - parameters.circleRadius;
+
+	nodes[0].left = bounds.leftSide;
+	nodes[0].right = bounds.rightSide;
+	nodes[0].height = bounds.lowerSide;
+	for (int i = 0; i < level.NumOfPlatforms(); i++) {
+		nodes[i + 1].left = level.platformsLeft[i];
+		nodes[i + 1].right = level.platformsRight[i];
+		nodes[i + 1].height = level.platformsUpper[i];
+	}
+}
+
+void NavGraph::SimulateNodes(const Level & level, const std::vector<int> & dirtyNodes, ThreadPool * pool) {
+	// every node only writes its own links and sweep, so they can run in parallel
+	std::function<void(size_t, size_t)> simulate = [this, &level, &dirtyNodes](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) SimulateNode(level, dirtyNodes[i]);
+	};
+	if (pool != nullptr) pool->ParallelFor(dirtyNodes.size(), 1, simulate);
+	else simulate(0, dirtyNodes.size());
+}
+
+void NavGraph::SimulateNode(const Level & level, int node) {
+	const NavNode& surface = nodes[node];
+	float radius = parameters.circleRadius;
+	std::vector<NavLink>& outgoing = nodeLinks[node];
+	Collider sweep = {FLT_MAX, -FLT_MAX, FLT_MAX, -FLT_MAX};
+	outgoing.clear();
+
+	// keeps the quickest link to each node per link type
+	auto keep = [&outgoing](const NavLink &link) {
+		for (NavLink& existing : outgoing) {
+			if (existing.to != link.to || existing.type != link.type) continue;
+			if (link.time < existing.time) existing = link;
+			return;
+		}
+		outgoing.push_back(link);
+	};
+
+	// Walk onto surfaces at the same height that the circle can bridge to
+	for (size_t i = 0; i < nodes.size(); i++) {
+		const NavNode& other = nodes[i];
+		if ((int)i == node || other.height != surface.height) continue;
+		float gap = glm::max(other.left - surface.right, surface.left - other.right);
+		if (gap > radius) continue;
+
+		bool toRight = other.left >= surface.left;
+		float launchX = toRight ? surface.right : surface.left;
+		float landX = glm::clamp(launchX, other.left, other.right);
+
+		float time = glm::max(glm::abs(landX - launchX) / parameters.velocityX, tickDelta);
+		keep({node, (int32_t)i, NAV_WALK, toRight ? (uint32_t)INPUT_RIGHT : (uint32_t)INPUT_LEFT, launchX, landX, time});
+	}
+
+	// Jump from points spread along the surface, fall off both edges
+	float left = glm::max(surface.left, parameters.leftmostPosition);
+	float right = glm::min(surface.right, parameters.rightmostPosition);
+	if (left <= right) {
+		int numOfLaunches = 2 + (int)((right - left) / (2.0f * radius));
+		for (int i = 0; i < numOfLaunches; i++) {
+			float launchX = left + (right - left) * i / (numOfLaunches - 1);
+			for (unsigned int inputBits : jumpInputs) {
+				NavLink link;
+				if (SimulateArc(level, node, launchX, inputBits, link, sweep)) keep(link);
+			}
+		}
+
+		if (node != 0) {
+			for (unsigned int inputBits : leftFallInputs) {
+				NavLink link;
+				if (SimulateArc(level, node, left, inputBits, link, sweep)) keep(link);
+			}
+			for (unsigned int inputBits : rightFallInputs) {
+				NavLink link;
+				if (SimulateArc(level, node, right, inputBits, link, sweep)) keep(link);
+			}
+		}
+	}
+
+	nodes[node].sweep = sweep;
+}
+
+// Places a player at rest on the node, then holds the inputs until it lands on another one
+bool NavGraph::SimulateArc(const Level & level, int node, float launchX, unsigned int inputBits, NavLink & link, Collider & sweep) const {
+	float radius = parameters.circleRadius;
+	PlayerState state;
+	state.position = glm::vec2(launchX, nodes[node].height + radius);
+
+	for (int i = 0; i < settleTicks && !state.onGround; i++) {
+		PlayerPhysics::ApplyInput(state, parameters, 0, tickDelta);
+		PlayerPhysics::Update(state, parameters, tickDelta, level);
+	}
+	if (!state.onGround || NodeAt(state.position) != node) return false; // covered by another platform
+	link.launchX = state.position.x;
+
+	bool airborne = false;
+	int maxTicks = (int)(maxArcTime / tickDelta);
+	for (int tick = 1; tick <= maxTicks; tick++) {
+		PlayerPhysics::ApplyInput(state, parameters, inputBits, tickDelta);
+		PlayerPhysics::Update(state, parameters, tickDelta, level);
+		Expand(sweep, state.position, radius);
+
+		if (!state.onGround) {
+			airborne = true;
+			continue;
+		}
+		if (!airborne) continue;
+
+		int landedOn = NodeAt(state.position);
+		if (landedOn < 0 || landedOn == node) return false;
+
+		link.from = node;
+		link.to = landedOn;
+		link.type = (inputBits & INPUT_UP) ? NAV_JUMP : NAV_FALL;
+		link.inputBits = inputBits;
+		link.landX = state.position.x;
+		link.time = tick * tickDelta;
+		return true;
+	}
+	return false;
+}
+
+void NavGraph::FlattenLinks() {
+	links.clear();
+	for (size_t i = 0; i < nodes.size(); i++) {
+		nodes[i].firstLink = (uint32_t)links.size();
+		nodes[i].numOfLinks = (uint32_t)nodeLinks[i].size();
+		links.insert(links.end(), nodeLinks[i].begin(), nodeLinks[i].end());
+	}
+
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	pathCache.clear();
+}
+
+// A* over the nodes. Cost is time: walking along a surface from where the
+// previous link landed to where the next one launches, plus the link itself.
+// The horizontal gap between two surfaces at top speed never overestimates.
+bool NavGraph::Search(int from, int to, std::vector<int> & path) const {
+	const NavNode& goal = nodes[to];
+	float topSpeed = parameters.velocityX + parameters.hyperSpeedup;
+	auto heuristic = [&goal, topSpeed](const NavNode &node) {
+		float gap = glm::max(0.0f, glm::max(node.left - goal.right, goal.left - node.right));
+		return gap / topSpeed;
+	};
+
+	size_t numOfNodes = nodes.size();
+	std::vector<float> cost(numOfNodes, FLT_MAX);
+	std::vector<float> arrivalX(numOfNodes);
+	std::vector<int> viaLink(numOfNodes, -1);
+	std::vector<unsigned char> closed(numOfNodes, 0);
+
+	typedef std::pair<float, int> OpenNode; // estimated total cost, node
+	std::priority_queue<OpenNode, std::vector<OpenNode>, std::greater<OpenNode>> open;
+	cost[from] = 0.0f;
+	arrivalX[from] = 0.5f * (nodes[from].left + nodes[from].right);
+	open.push(OpenNode(heuristic(nodes[from]), from));
+
+	while (!open.empty()) {
+		int current = open.top().second;
+		open.pop();
+		if (closed[current]) continue;
+		closed[current] = 1;
+		if (current == to) break;
+
+		const NavNode& node = nodes[current];
+		for (uint32_t i = node.firstLink; i < node.firstLink + node.numOfLinks; i++) {
+			const NavLink& link = links[i];
+			if (closed[link.to]) continue;
+
+			float walk = glm::abs(arrivalX[current] - link.launchX) / parameters.velocityX;
+			float newCost = cost[current] + walk + link.time;
+			if (newCost >= cost[link.to]) continue;
+
+			cost[link.to] = newCost;
+			arrivalX[link.to] = link.landX;
+			viaLink[link.to] = (int)i;
+			open.push(OpenNode(newCost + heuristic(nodes[link.to]), link.to));
+		}
+	}
+	if (viaLink[to] < 0) return false;
+
+	for (int node = to; node != from; node = links[viaLink[node]].from) path.push_back(viaLink[node]);
+	std::reverse(path.begin(), path.end());
+	return true;
+}
@@ -0,0 +1,239 @@
+#include <cstdint>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define PARTICLES_SSE
+#endif
+#include <GLAD/glad.h>
+#include <GLM/glm.hpp>
+
+#include "ParticleSystem.h"
+#include "ShaderProgram.h"
+#include "Profiler.h"
+
+
+// Unit quad, scaled & moved per instance in the vertex shader
+static const float quadCorners[4 * 2] = {
+	-0.5f, -0.5f, // lower left
+	 0.5f, -0.5f, // lower right
+	 0.5f,  0.5f, // upper right
+	-0.5f,  0.5f  // upper left
+};
+static const unsigned int quadIndices[6] = {0, 1, 3, 1, 2, 3};
+
+// Indexed by Particle_Material
+static const ParticleMaterial particleMaterials[NUM_OF_PARTICLE_MATERIALS] = {
+	// color                         min velocity                max velocity               life          size            gravity drag
+	{glm::vec4(0.8f, 0.75f, 0.6f, 0.6f), glm::vec2(-0.5f, 0.05f), glm::vec2(0.5f, 0.35f), 0.3f, 0.6f, 0.015f, 0.035f, 1.0f, 3.0f}, // dust
+	{glm::vec4(1.0f, 0.3f, 0.2f, 0.5f),  glm::vec2(-0.05f, -0.05f), glm::vec2(0.05f, 0.05f), 0.3f, 0.5f, 0.02f, 0.04f, 0.0f, 1.0f}, // trail
+	{glm::vec4(0.6f, 0.1f, 0.05f, 0.9f), glm::vec2(-1.0f, 0.5f), glm::vec2(1.0f, 1.5f),   0.5f, 0.9f, 0.01f, 0.025f, 4.0f, 0.5f}, // debris
+};
+
+
+// Public Functions:
+
+void ParticleSystem::Setup(const ShaderSources & shaderSources, int capacityPerMaterial) {
+	capacity = (capacityPerMaterial + 3) / 4 * 4; // whole SIMD groups
+
+	// Shared quad (per vertex)
+	glGenBuffers(1, &quadVBO);
+	glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(quadCorners), quadCorners, GL_STATIC_DRAW);
+	glGenBuffers(1, &quadEBO);
+
+	for (ParticlePool& pool : pools) {
+		// all the memory a pool will ever use
+		pool.positionX.resize(capacity);
+		pool.positionY.resize(capacity);
+		pool.velocityX.resize(capacity);
+		pool.velocityY.resize(capacity);
+		pool.life.resize(capacity);
+		pool.inverseLifetime.resize(capacity);
+		pool.size.resize(capacity);
+		pool.instances.resize(capacity);
+
+		glGenVertexArrays(1, &pool.vaoId);
+		glBindVertexArray(pool.vaoId);
+
+		glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+		glEnableVertexAttribArray(0);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadEBO);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(quadIndices), quadIndices, GL_STATIC_DRAW);
+
+		// Center, size & life left (per instance)
+		glGenBuffers(1, &pool.instanceVBO);
+		glBindBuffer(GL_ARRAY_BUFFER, pool.instanceVBO);
+		glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(glm::vec4), NULL, GL_STREAM_DRAW);
+		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)0);
+		glEnableVertexAttribArray(1);
+		glVertexAttribDivisor(1, 1);
+	}
+
+	// Assign shaders to shader program
+	shaderProgram.Setup(shaderSources);
+
+	// Unbind VAO
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void ParticleSystem::Emit(Particle_Material material, glm::vec2 position, int count) {
+	ParticlePool& pool = pools[material];
+	const ParticleMaterial& look = particleMaterials[material];
+	count = glm::min(count, capacity - pool.count);
+
+	for (int i = pool.count; i < pool.count + count; i++) {
+		float lifetime = Random(look.minLife, look.maxLife);
+		pool.positionX[i] = position.x;
+		pool.positionY[i] = position.y;
+		pool.velocityX[i] = Random(look.minVelocity.x, look.maxVelocity.x);
+		pool.velocityY[i] = Random(look.minVelocity.y, look.maxVelocity.y);
+		pool.life[i] = lifetime;
+		pool.inverseLifetime[i] = 1.0f / lifetime;
+		pool.size[i] = Random(look.minSize, look.maxSize);
+	}
+	pool.count += count;
+}
+
+void ParticleSystem::Update(float deltaTime) {
+	PROFILE_SCOPE("ParticleSystem::Update");
+	for (int material = 0; material < NUM_OF_PARTICLE_MATERIALS; material++) {
+		ParticlePool& pool = pools[material];
+		if (pool.count == 0) continue;
+		Integrate(pool, particleMaterials[material], deltaTime);
+		RemoveDead(pool);
+	}
+}
+
+void ParticleSystem::Draw(const glm::mat4 & viewProjection) {
+	PROFILE_SCOPE("ParticleSystem::Draw");
+	if (NumOfAlive() == 0) return;
+
+	shaderProgram.activate();
+	shaderProgram.setMat4Uniform("viewProjection", viewProjection);
+
+	for (int material = 0; material < NUM_OF_PARTICLE_MATERIALS; material++) {
+		ParticlePool& pool = pools[material];
+		if (pool.count == 0) continue;
+
+		glBindBuffer(GL_ARRAY_BUFFER, pool.instanceVBO);
+		glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(glm::vec4), NULL, GL_STREAM_DRAW); // orphan last frame's storage
+		glBufferSubData(GL_ARRAY_BUFFER, 0, pool.count * sizeof(glm::vec4), pool.instances.data());
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		shaderProgram.setVec4Uniform("particleColor", particleMaterials[material].color);
+		glBindVertexArray(pool.vaoId);
+		glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, pool.count);
+	}
+
+	shaderProgram.deactivate();
+	glBindVertexArray(0);
+}
+
+void ParticleSystem::DeleteVAO() {
+	for (ParticlePool& pool : pools) {
+		glDeleteVertexArrays(1, &pool.vaoId);
+		glDeleteBuffers(1, &pool.instanceVBO);
+	}
+	glDeleteBuffers(1, &quadVBO);
+	glDeleteBuffers(1, &quadEBO);
+}
+
+
+int ParticleSystem::NumOfAlive() const {
+	int alive = 0;
+	for (const ParticlePool& pool : pools) alive += pool.count;
+	return alive;
+}
+
+
+
+
+// Private Functions:
+
+// xorshift32, plenty for where a speck of dust flies
+float ParticleSystem::Random(float low, float high) {
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 17;
+	randomState ^= randomState << 5;
+	return low + (high - low) * ((float)(randomState >> 8) * (1.0f / 16777216.0f));
+}
+
+// Same operations on every particle, 4 at a time, then packed into the
+// instance array while still in registers. Groups are padded past the last
+// particle; the padding lanes are updated too but never drawn.
+void ParticleSystem::Integrate(ParticlePool & pool, const ParticleMaterial & material, float deltaTime) {
+	float* positionX = pool.positionX.data();
+	float* positionY = pool.positionY.data();
+	float* velocityX = pool.velocityX.data();
+	float* velocityY = pool.velocityY.data();
+	float* life = pool.life.data();
+	const float* inverseLifetime = pool.inverseLifetime.data();
+	const float* size = pool.size.data();
+	float* instances = &pool.instances[0][0];
+	float damping = glm::max(1.0f - material.drag * deltaTime, 0.0f);
+	float fall = material.gravity * deltaTime;
+	int paddedCount = (pool.count + 3) / 4 * 4;
+
+#ifdef PARTICLES_SSE
+	__m128 dampings = _mm_set1_ps(damping), falls = _mm_set1_ps(fall), deltas = _mm_set1_ps(deltaTime);
+	for (int i = 0; i < paddedCount; i += 4) {
+		__m128 vx = _mm_mul_ps(_mm_loadu_ps(velocityX + i), dampings);
+		__m128 vy = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(velocityY + i), dampings), falls);
+		__m128 x = _mm_add_ps(_mm_loadu_ps(positionX + i), _mm_mul_ps(vx, deltas));
+		__m128 y = _mm_add_ps(_mm_loadu_ps(positionY + i), _mm_mul_ps(vy, deltas));
+		__m128 lifeLeft = _mm_sub_ps(_mm_loadu_ps(life + i), deltas);
+		_mm_storeu_ps(velocityX + i, vx);
+		_mm_storeu_ps(velocityY + i, vy);
+		_mm_storeu_ps(positionX + i, x);
+		_mm_storeu_ps(positionY + i, y);
+		_mm_storeu_ps(life + i, lifeLeft);
+
+		// 4 particles' x, y, size & fraction of life left become 4 vec4s
+		__m128 sizes = _mm_loadu_ps(size + i);
+		__m128 fractions = _mm_mul_ps(lifeLeft, _mm_loadu_ps(inverseLifetime + i));
+		_MM_TRANSPOSE4_PS(x, y, sizes, fractions);
+		_mm_storeu_ps(instances + 4 * i, x);
+		_mm_storeu_ps(instances + 4 * i + 4, y);
+		_mm_storeu_ps(instances + 4 * i + 8, sizes);
+		_mm_storeu_ps(instances + 4 * i + 12, fractions);
+	}
+#else
+	for (int i = 0; i < paddedCount; i++) {
+		velocityX[i] *= damping;
+		velocityY[i] = velocityY[i] * damping - fall;
+		positionX[i] += velocityX[i] * deltaTime;
+		positionY[i] += velocityY[i] * deltaTime;
+		life[i] -= deltaTime;
+		instances[4 * i]     = positionX[i];
+		instances[4 * i + 1] = positionY[i];
+		instances[4 * i + 2] = size[i];
+		instances[4 * i + 3] = life[i] * inverseLifetime[i];
+	}
+#endif
+}
+
+// Only the few particles that died this frame cost anything: the last alive
+// particle takes each one's place (draw order doesn't matter for specks)
+void ParticleSystem::RemoveDead(ParticlePool & pool) {
+	float* life = pool.life.data();
+	int count = pool.count;
+	for (int i = 0; i < count;) {
+		if (life[i] > 0.0f) {
+			i++;
+			continue;
+		}
+
+		count--;
+		pool.positionX[i] = pool.positionX[count];
+		pool.positionY[i] = pool.positionY[count];
+		pool.velocityX[i] = pool.velocityX[count];
+		pool.velocityY[i] = pool.velocityY[count];
+		life[i] = life[count];
+		pool.inverseLifetime[i] = pool.inverseLifetime[count];
+		pool.size[i] = pool.size[count];
+		pool.instances[i] = pool.instances[count];
+	}
+	pool.count = count;
+}
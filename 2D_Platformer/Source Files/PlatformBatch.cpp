@@ -0,0 +1,103 @@
+#include <vector>
+
+#include <GLAD/glad.h>
+#include <GLM/glm.hpp>
+
+#include "ShaderProgram.h"
+#include "Level.h"
+#include "PlatformBatch.h"
+#include "Profiler.h"
+
+
+// Unit quad, scaled & moved per instance in the vertex shader
+static const float quadCorners[4 * 2] = {
+	-0.5f, -0.5f, // lower left
+	 0.5f, -0.5f, // lower right
+	 0.5f,  0.5f, // upper right
+	-0.5f,  0.5f  // upper left
+};
+static const unsigned int quadIndices[6] = {0, 1, 3, 1, 2, 3};
+
+
+// Public Functions:
+
+void PlatformBatch::Setup(const ShaderSources & shaderSources) {
+	// Create vertex array object
+	glGenVertexArrays(1, &vaoId);
+	glBindVertexArray(vaoId);
+
+	// Shared quad (per vertex)
+	glGenBuffers(1, &quadVBO);
+	glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(quadCorners), quadCorners, GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+
+	glGenBuffers(1, &quadEBO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadEBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(quadIndices), quadIndices, GL_STATIC_DRAW);
+
+	// Center & size (per instance)
+	glGenBuffers(1, &instanceVBO);
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+	glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)0);
+	glEnableVertexAttribArray(1);
+	glVertexAttribDivisor(1, 1);
+
+	// Assign shaders to shader program
+	shaderProgram.Setup(shaderSources);
+
+	// Unbind VAO
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void PlatformBatch::Upload(const Level & level) {
+	instances.assign(level.platformsInstances, level.platformsInstances + level.NumOfPlatforms());
+	visible.clear();
+	visible.reserve(instances.size()); // never grows while drawing
+
+	capacity = (unsigned int)instances.size();
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+	glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(glm::vec4), NULL, GL_STREAM_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void PlatformBatch::UpdateInstance(int i, glm::vec4 instance) {
+	instances[i] = instance;
+}
+
+void PlatformBatch::Draw(glm::vec4 region, const glm::mat4& viewProjection) {
+	PROFILE_SCOPE("PlatformBatch::Draw");
+
+	// Keep the platforms overlapping the region, in level order
+	visible.clear();
+	for (const glm::vec4& instance : instances) {
+		glm::vec2 halfSize = 0.5f * glm::vec2(instance.z, instance.w);
+		bool outside = (instance.x + halfSize.x < region.x) | (instance.x - halfSize.x > region.z) |
+		               (instance.y + halfSize.y < region.y) | (instance.y - halfSize.y > region.w);
+		if (!outside) visible.push_back(instance);
+	}
+	if (visible.empty()) return;
+
+	glBindVertexArray(vaoId);
+	shaderProgram.activate();
+	shaderProgram.setMat4Uniform("viewProjection", viewProjection);
+
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+	glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(glm::vec4), NULL, GL_STREAM_DRAW); // orphan the last upload
+	glBufferSubData(GL_ARRAY_BUFFER, 0, visible.size() * sizeof(glm::vec4), visible.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, (GLsizei)visible.size());
+
+	shaderProgram.deactivate();
+	glBindVertexArray(0);
+}
+
+void PlatformBatch::DeleteVAO() {
+	glDeleteVertexArrays(1, &vaoId);
+	glDeleteBuffers(1, &quadVBO);
+	glDeleteBuffers(1, &quadEBO);
+	glDeleteBuffers(1, &instanceVBO);
+}
@@ -0,0 +1,171 @@
+#include <vector>
+#include <GLM/glm.hpp>
+
+#include "PlayerPhysics.h"
+#include "Level.h"
+#include "CollisionWorld.h"
+
+
+// Colliders a player is usually resolved against in one tick, more go to a per thread overflow buffer
+static const int maxColliders = 64;
+
+
+// Public Functions:
+
+PlayerParameters PlayerPhysics::Parameters(float radius, const CollisionWorld & world) {
+	Collider bounds = world.Bounds();
+	PlayerParameters parameters;
+	parameters.circleRadius = radius;
+	parameters.highestPoint = bounds.upperSide - radius;
+	parameters.lowestPoint = bounds.lowerSide + radius;
+	parameters.leftmostPosition = bounds.leftSide + radius;
+	parameters.rightmostPosition = bounds.rightSide - radius;
+	return parameters;
+}
+
+PlayerState PlayerPhysics::Spawn(const Level & level) {
+	PlayerState state;
+	state.position = level.spawnPoint;
+	return state;
+}
+
+
+void PlayerPhysics::ApplyInput(PlayerState & state, const PlayerParameters & parameters, unsigned int inputBits, float deltaTime) {
+	if (inputBits & INPUT_UP)    Move(state, parameters, UP, deltaTime);
+	if (inputBits & INPUT_RIGHT) Move(state, parameters, RIGHT, deltaTime);
+	if (inputBits & INPUT_LEFT)  Move(state, parameters, LEFT, deltaTime);
+	(inputBits & INPUT_HYPER) ? GetHyper(state, parameters) : BeNormal(state);
+}
+
+void PlayerPhysics::Move(PlayerState & state, const PlayerParameters & parameters, Player_Movement key, float deltaTime) {
+	if (key == UP && state.onGround) state.velocityY = parameters.kickoff + state.speedup; // jump
+
+	if (key == RIGHT) state.position.x += (parameters.velocityX + state.speedup) * deltaTime; // move right
+	if (key == LEFT)  state.position.x -= (parameters.velocityX + state.speedup) * deltaTime; // move left
+}
+
+void PlayerPhysics::GetHyper(PlayerState & state, const PlayerParameters & parameters) {if (!state.tired) state.speedup = parameters.hyperSpeedup;}
+void PlayerPhysics::BeNormal(PlayerState & state) {state.speedup = 0.0f; state.timer = 0.0f;}
+
+
+void PlayerPhysics::Update(PlayerState & state, const PlayerParameters & parameters, float deltaTime, const CollisionWorld & world) {
+	float circleRadius = parameters.circleRadius;
+
+	// Make sure player doesn't get out of the world
+	state.position.x = glm::max(parameters.leftmostPosition, glm::min(parameters.rightmostPosition, state.position.x));
+	state.position.y = glm::min(parameters.highestPoint, glm::max(state.position.y + state.velocityY * deltaTime, parameters.lowestPoint));
+
+	// Check if player is on ground
+	state.onGround = false;
+	if (state.position.y == parameters.lowestPoint) state.onGround = true;
+
+	// limit hyper mode time
+	if (IsHyper(state)) {
+		state.timer += deltaTime;
+		if (state.timer > parameters.hyperTime) state.tired = true, state.speedup = 0.0f, state.timer = 0.0f;
+	}
+
+	// prevent entering hyper mode until cooldown
+	if (state.tired) {
+		state.timer += deltaTime;
+		if (state.timer > parameters.cooldownTime) state.tired = false, state.timer = 0.0f;
+	}
+
+	// Check if collisions occur; the query reaches a radius further than the circle
+	// since resolving one collision can push the player towards the next
+	Collider nearColliders[maxColliders];
+	Collider* colliders = nearColliders;
+	float reach = 3.0f * circleRadius;
+	int numOfColliders = world.QueryColliders(state.position, reach, state.velocityY, colliders, maxColliders);
+	if (numOfColliders > maxColliders) {
+		// a crowded spot: query again into a buffer that fits them all, it only grows
+		static thread_local std::vector<Collider> overflow;
+		if ((int)overflow.size() < numOfColliders) overflow.resize(numOfColliders);
+		colliders = overflow.data();
+		numOfColliders = glm::min(world.QueryColliders(state.position, reach, state.velocityY, colliders, (int)overflow.size()), (int)overflow.size());
+	}
+	for (int i = 0; i < numOfColliders; i++) {
+		const Collider& platform = colliders[i];
+		// cheap reject on the x axis
+		if (state.position.x + circleRadius < platform.leftSide || state.position.x - circleRadius > platform.rightSide) continue;
+
+		Contact contact;
+		if (DetectCollision(state, parameters, platform, contact)) Collide(state, parameters, platform, contact);
+	}
+
+
+	// Calculate new "velocityY" value
+	if (state.onGround)                                  state.velocityY = 0.0f;
+	else if (state.position.y == parameters.highestPoint) state.velocityY = glm::min(0.0f, state.velocityY - parameters.gravity * deltaTime);
+	else                                                  state.velocityY -= parameters.gravity * deltaTime;
+}
+
+
+
+
+// Private Functions:
+
+bool PlayerPhysics::DetectCollision(const PlayerState & state, const PlayerParameters & parameters, const Collider & platform, Contact & contact) {
+	// calculate the closest point on platform to circle
+	contact.closestX = glm::max(platform.leftSide,  glm::min(state.position.x, platform.rightSide));
+	contact.closestY = glm::max(platform.lowerSide, glm::min(state.position.y, platform.upperSide));
+
+	// calculate square distance between point and circle center
+	contact.distanceX = state.position.x - contact.closestX;
+	contact.distanceY = state.position.y - contact.closestY;
+	float distanceSquare = (contact.distanceX * contact.distanceX) + (contact.distanceY * contact.distanceY);
+
+
+	// if circle collides with platform
+	return (distanceSquare < (parameters.circleRadius * parameters.circleRadius));
+}
+
+
+void PlayerPhysics::Collide(PlayerState & state, const PlayerParameters & parameters, const Collider & platform, const Contact & contact) {
+	// circle equation: (x - centerX) ^ 2	+ (y - centerY) ^ 2 = (radius) ^ 2
+	// application    :    firstTerm        +     secondTerm    = radiusSquare
+	float circleRadius = parameters.circleRadius;
+	float radiusSquare = circleRadius * circleRadius;
+	glm::vec2 &playerPosition = state.position;
+
+	if (contact.closestY == platform.upperSide && glm::abs(contact.distanceX) < (0.5f * circleRadius)) { // circle is above platform
+
+		if (contact.closestX == platform.leftSide) { // upper left corner
+			float firstTerm = (playerPosition.x - platform.leftSide) * (playerPosition.x - platform.leftSide);
+			playerPosition.y = glm::sqrt(radiusSquare - firstTerm) + platform.upperSide;
+
+		} else if (contact.closestX == platform.rightSide) { // upper right corner
+			float firstTerm = (playerPosition.x - platform.rightSide) * (playerPosition.x - platform.rightSide);
+			playerPosition.y = glm::sqrt(radiusSquare - firstTerm) + platform.upperSide;
+
+		} else {
+			playerPosition.y = glm::max(playerPosition.y, platform.upperSide + circleRadius);
+		}
+
+		state.onGround = true;
+
+
+	} else if (contact.closestY == platform.lowerSide) { // circle is below platform
+		state.velocityY = glm::min(state.velocityY, 0.0f);
+
+		if (contact.closestX == platform.leftSide) { // lower left corner
+			float firstTerm = (playerPosition.x - platform.leftSide) * (playerPosition.x - platform.leftSide);
+			playerPosition.y = -glm::sqrt(radiusSquare - firstTerm) + platform.lowerSide;
+
+		} else if (contact.closestX == platform.rightSide) { // lower right corner
+			float firstTerm = (playerPosition.x - platform.rightSide) * (playerPosition.x - platform.rightSide);
+			playerPosition.y = -glm::sqrt(radiusSquare - firstTerm) + platform.lowerSide;
+
+		} else {
+			playerPosition.y = glm::min(playerPosition.y, platform.lowerSide - circleRadius);
+		}
+
+
+	} else if (contact.closestX == platform.leftSide) { // circle is left of platform
+		playerPosition.x = platform.leftSide - circleRadius;
+
+	} else if (contact.closestX == platform.rightSide) { // circle is right of platform
+		playerPosition.x = platform.rightSide + circleRadius;
+
+	}
+}
@@ -0,0 +1,135 @@
+#include "Profiler.h"
+
+#ifdef PLATFORMER_PROFILE
+
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+
+// Every thread writes its events into its own ring, so recording never takes a
+// lock. Fields are relaxed atomics (plain stores on x86) so the dump can read
+// a ring while its thread keeps writing; an event caught mid-write is dropped
+// by checking the write index again after copying.
+namespace {
+	const uint64_t ringSize = 1 << 16; // events per thread, power of two
+	const uint64_t frameRingSize = 1024;
+
+	struct ProfileEvent {
+		std::atomic<const char*> name;
+		std::atomic<uint64_t> start, end;
+	};
+
+	struct ThreadEvents {
+		std::string threadName;
+		unsigned int threadId;
+		std::atomic<uint64_t> written {0};
+		ProfileEvent events[ringSize];
+	};
+
+	std::mutex registryMutex;
+	std::vector<std::unique_ptr<ThreadEvents>> registry; // rings outlive their threads
+
+	std::atomic<uint64_t> frameStarts[frameRingSize];
+	std::atomic<uint64_t> numOfFrames {0};
+
+	ThreadEvents& ThisThread() {
+		thread_local ThreadEvents* thisThread = nullptr;
+		if (thisThread == nullptr) {
+			std::lock_guard<std::mutex> lock(registryMutex);
+			registry.emplace_back(new ThreadEvents());
+			thisThread = registry.back().get();
+			thisThread->threadId = (unsigned int)registry.size();
+			thisThread->threadName = "Thread " + std::to_string(thisThread->threadId);
+		}
+		return *thisThread;
+	}
+
+	// Pairs a raw timestamp with steady_clock, at startup and again when writing,
+	// to convert ticks into microseconds since startup
+	struct TimeReference {
+		uint64_t ticks;
+		Profiler::Clock::time_point time;
+	};
+	const TimeReference startup = {Profiler::Now(), Profiler::Clock::now()};
+}
+
+
+// Public Functions:
+
+void Profiler::Record(const char* name, uint64_t start, uint64_t end) {
+	ThreadEvents& thread = ThisThread();
+	uint64_t index = thread.written.load(std::memory_order_relaxed);
+
+	ProfileEvent& event = thread.events[index & (ringSize - 1)];
+	event.name.store(name, std::memory_order_relaxed);
+	event.start.store(start, std::memory_order_relaxed);
+	event.end.store(end, std::memory_order_relaxed);
+	thread.written.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::SetThreadName(const char* name) {
+	ThreadEvents& thread = ThisThread();
+	std::lock_guard<std::mutex> lock(registryMutex);
+	thread.threadName = name;
+}
+
+void Profiler::MarkFrame() {
+	uint64_t frame = numOfFrames.load(std::memory_order_relaxed);
+	frameStarts[frame % frameRingSize].store(Now(), std::memory_order_relaxed);
+	numOfFrames.store(frame + 1, std::memory_order_release);
+}
+
+bool Profiler::WriteTrace(const char* path, unsigned int numOfTraceFrames) {
+	// Start of the oldest frame to keep
+	uint64_t frames = numOfFrames.load(std::memory_order_acquire);
+	numOfTraceFrames = (unsigned int)std::min<uint64_t>(std::min<uint64_t>(numOfTraceFrames, frames), frameRingSize - 1);
+	uint64_t since = numOfTraceFrames == 0 ? 0 : frameStarts[(frames - numOfTraceFrames) % frameRingSize].load(std::memory_order_relaxed);
+
+	TimeReference now = {Now(), Clock::now()};
+	double elapsedMicroseconds = std::chrono::duration<double, std::micro>(now.time - startup.time).count();
+	double microsecondsPerTick = elapsedMicroseconds / (double)std::max<uint64_t>(1, now.ticks - startup.ticks);
+
+	std::ofstream traceStream(path);
+	if (!traceStream) {
+		std::cout << "ERROR::PROFILER::FILE_NOT_SUCCESSFULLY_WRITTEN: " << path << std::endl;
+		return false;
+	}
+	traceStream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+	std::lock_guard<std::mutex> lock(registryMutex);
+	bool first = true;
+	size_t numOfEvents = 0;
+	for (const std::unique_ptr<ThreadEvents>& thread : registry) {
+		traceStream << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread->threadId
+			<< ",\"args\":{\"name\":\"" << thread->threadName << "\"}}";
+		first = false;
+
+		uint64_t written = thread->written.load(std::memory_order_acquire);
+		uint64_t oldest = written > ringSize ? written - ringSize : 0;
+		for (uint64_t i = oldest; i < written; i++) {
+			const ProfileEvent& event = thread->events[i & (ringSize - 1)];
+			const char* name = event.name.load(std::memory_order_relaxed);
+			uint64_t start = event.start.load(std::memory_order_relaxed);
+			uint64_t end = event.end.load(std::memory_order_relaxed);
+
+			// skip events overwritten while reading them
+			if (thread->written.load(std::memory_order_acquire) - i >= ringSize) continue;
+			if (start < since || start < startup.ticks) continue;
+
+			traceStream << ",\n{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->threadId
+				<< ",\"ts\":" << std::fixed << (start - startup.ticks) * microsecondsPerTick << ",\"dur\":" << (end - start) * microsecondsPerTick << "}";
+			numOfEvents++;
+		}
+	}
+	traceStream << "\n]}\n";
+
+	std::cout << "Wrote " << numOfEvents << " profile events (" << numOfTraceFrames << " frames) -> " << path << std::endl;
+	return true;
+}
+
+#endif
@@ -2,55 +2,45 @@
 #include <GLM/glm.hpp>
 
 #include <string>
-#include <fstream>
+#include <vector>
 #include <sstream>
 #include <iostream>
 
 #include "ShaderProgram.h"
+#include "FileSystem.h"
 
 
 // Public Functions:
 
-void ShaderProgram::Setup(const char * vrtxPath, const char * frgmtPath, const char * gmtryPath) {
-	// Source codes
-	std::string vrtxSrcCode, frgmtSrcCode, gmtrySrcCode;
-
-	// Input file streams
-	std::ifstream vrtxFileStream, frgmtFileStream, gmtryFileStream;
-
-	vrtxFileStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-	frgmtFileStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-	gmtryFileStream.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-
-	try {
-		// open files
-		vrtxFileStream.open(vrtxPath);
-		frgmtFileStream.open(frgmtPath);
+bool ShaderProgram::ReadSources(const char * vrtxPath, const char * frgmtPath, const char * gmtryPath, ShaderSources & sources) {
+	// read files through the file system (asset pack or loose files), resolving includes
+	bool filesRead = Preprocess(vrtxPath, sources.vertex);
+	if (frgmtPath != nullptr) filesRead = filesRead && Preprocess(frgmtPath, sources.fragment);
+	else sources.fragment.clear();
+	if (gmtryPath != nullptr) filesRead = filesRead && Preprocess(gmtryPath, sources.geometry);
+	else sources.geometry.clear();
 
-		std::stringstream vrtxStringStream, frgmtStringStream;
-
-		// read file's buffer contents into streams
-		vrtxStringStream << vrtxFileStream.rdbuf();
-		frgmtStringStream << frgmtFileStream.rdbuf();
+	if (!filesRead) {
+		std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ" << std::endl;
+		return false;
+	}
+	return true;
+}
 
-		// close files
-		vrtxFileStream.close();
-		frgmtFileStream.close();
+void ShaderProgram::Setup(const char * vrtxPath, const char * frgmtPath, const char * gmtryPath) {
+	ShaderSources sources;
+	ReadSources(vrtxPath, frgmtPath, gmtryPath, sources);
+	Setup(sources);
+}
 
-		// convert stream into string
-		vrtxSrcCode = vrtxStringStream.str();
-		frgmtSrcCode = frgmtStringStream.str();
+void ShaderProgram::Setup(const ShaderSources & sources, const std::vector<std::string>& defines) {
+	bool hasFragment = !sources.fragment.empty(); // a transform feedback pass may have none
+	bool hasGeometry = !sources.geometry.empty();
 
-		if (gmtryPath != nullptr) {
-			gmtryFileStream.open(gmtryPath);
-			std::stringstream gmtryStringStream;
-			gmtryStringStream << gmtryFileStream.rdbuf();
-			gmtryFileStream.close();
-			gmtrySrcCode = gmtryStringStream.str();
-		}
-	} catch (std::ifstream::failure e) {
-		std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ" << std::endl;
-	}
+	// Source codes with this variant's defines
+	std::string vrtxSrcCode = InjectDefines(sources.vertex, defines);
+	std::string frgmtSrcCode = hasFragment ? InjectDefines(sources.fragment, defines) : std::string();
+	std::string gmtrySrcCode = hasGeometry ? InjectDefines(sources.geometry, defines) : std::string();
 
 	// Source codes but in (const char*) form not strings
 	const char* vrtxCode = vrtxSrcCode.c_str();
@@ -63,14 +53,17 @@ void ShaderProgram::Setup(const char * vrtxPath, const char * frgmtPath, const c
 	checkCompileErrors(vrtxId, "VERTEX");
 
 	// fragment shader
-	unsigned int frgmtId = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(frgmtId, 1, &frgmtCode, NULL);
-	glCompileShader(frgmtId);
-	checkCompileErrors(frgmtId, "FRAGMENT");
+	unsigned int frgmtId;
+	if (hasFragment) {
+		frgmtId = glCreateShader(GL_FRAGMENT_SHADER);
+		glShaderSource(frgmtId, 1, &frgmtCode, NULL);
+		glCompileShader(frgmtId);
+		checkCompileErrors(frgmtId, "FRAGMENT");
+	}
 
 	// geometry shader
 	unsigned int gmtryId;
-	if (gmtryPath != nullptr) {
+	if (hasGeometry) {
 		const char* gmtryCode = gmtrySrcCode.c_str();
 		gmtryId = glCreateShader(GL_GEOMETRY_SHADER);
 		glShaderSource(gmtryId, 1, &gmtryCode, NULL);
@@ -83,16 +76,23 @@ void ShaderProgram::Setup(const char * vrtxPath, const char * frgmtPath, const c
 	shaderProgramId = glCreateProgram();
 
 	glAttachShader(shaderProgramId, vrtxId);
-	glAttachShader(shaderProgramId, frgmtId);
-	if (gmtryPath != nullptr) glAttachShader(shaderProgramId, gmtryId);
+	if (hasFragment) glAttachShader(shaderProgramId, frgmtId);
+	if (hasGeometry) glAttachShader(shaderProgramId, gmtryId);
+
+	// transform feedback outputs are chosen before linking
+	if (!sources.feedbackVaryings.empty()) {
+		std::vector<const char*> varyings;
+		for (const std::string& varying : sources.feedbackVaryings) varyings.push_back(varying.c_str());
+		glTransformFeedbackVaryings(shaderProgramId, (GLsizei)varyings.size(), varyings.data(), GL_INTERLEAVED_ATTRIBS);
+	}
 
 	glLinkProgram(shaderProgramId);
 
 	checkCompileErrors(shaderProgramId, "PROGRAM");
 
 	glDeleteShader(vrtxId);
-	glDeleteShader(frgmtId);
-	if (gmtryPath != nullptr) glDeleteShader(gmtryId);
+	if (hasFragment) glDeleteShader(frgmtId);
+	if (hasGeometry) glDeleteShader(gmtryId);
 }
 
 void ShaderProgram::activate() {glUseProgram(shaderProgramId);}
@@ -140,4 +140,56 @@ void ShaderProgram::checkCompileErrors(GLuint shader, std::string type) {
 	}
 }
 
+// Splices `#include "path"` lines (path relative to the including file) into the source.
+// #line directives keep compiler error line numbers pointing into the right file.
+bool ShaderProgram::Preprocess(const std::string & path, std::string & source, int depth) {
+	const int maxIncludeDepth = 8; // catches include cycles
 
+	FileData file;
+	if (depth > maxIncludeDepth || !FileSystem::ReadFile(path.c_str(), file)) {
+		std::cout << "ERROR::SHADER::FILE_NOT_FOUND: " << path << std::endl;
+		return false;
+	}
+
+	std::string directory = path.substr(0, path.find_last_of('/') + 1);
+	std::istringstream lines(file.Text());
+	std::string line;
+	int lineNumber = 0;
+
+	source.clear();
+	while (std::getline(lines, line)) {
+		lineNumber++;
+
+		size_t start = line.find_first_not_of(" \t");
+		if (start == std::string::npos || line.compare(start, 8, "#include") != 0) {
+			source += line + '\n';
+			continue;
+		}
+
+		size_t open = line.find('"', start), close = line.find('"', open + 1);
+		std::string included;
+		if (open == std::string::npos || close == std::string::npos || !Preprocess(directory + line.substr(open + 1, close - open - 1), included, depth + 1)) {
+			std::cout << "ERROR::SHADER::BAD_INCLUDE in " << path << " line " << lineNumber << std::endl;
+			return false;
+		}
+		source += "#line 1\n" + included + "#line " + std::to_string(lineNumber + 1) + '\n';
+	}
+	return true;
+}
+
+// Defines go right after #version, which has to stay the first line
+std::string ShaderProgram::InjectDefines(const std::string & source, const std::vector<std::string>& defines) {
+	if (defines.empty()) return source;
+
+	std::string defineLines;
+	for (const std::string& define : defines) defineLines += "#define " + define + '\n';
+
+	size_t insertAt = 0;
+	if (source.compare(0, 8, "#version") == 0) {
+		insertAt = source.find('\n');
+		insertAt = insertAt == std::string::npos ? source.size() : insertAt + 1;
+	}
+	// keep the original line numbers after the defines
+	int versionLines = insertAt == 0 ? 0 : 1;
+	return source.substr(0, insertAt) + defineLines + "#line " + std::to_string(versionLines + 1) + '\n' + source.substr(insertAt);
+}
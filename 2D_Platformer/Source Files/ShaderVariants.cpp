@@ -0,0 +1,29 @@
+#include <GLAD/glad.h>
+
+#include <string>
+#include <vector>
+
+#include "ShaderVariants.h"
+#include "ShaderProgram.h"
+
+
+// Public Functions:
+
+// Every variant is compiled up front (during loading), so switching variants
+// never stalls a frame on the shader compiler
+void ShaderVariants::Setup(const ShaderSources & shaderSources, const std::vector<std::string>& permutationNames) {
+	permutations = permutationNames;
+	programs.resize((size_t)1 << permutations.size());
+
+	for (unsigned int flags = 0; flags < programs.size(); flags++) {
+		std::vector<std::string> defines;
+		for (size_t i = 0; i < permutations.size(); i++)
+			if (flags & (1u << i)) defines.push_back(permutations[i]);
+
+		programs[flags].Setup(shaderSources, defines);
+	}
+}
+
+ShaderProgram& ShaderVariants::Get(unsigned int flags) {
+	return programs[flags & (programs.size() - 1)];
+}
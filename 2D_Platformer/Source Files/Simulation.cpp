@@ -0,0 +1,166 @@
+#include <chrono>
+#include <thread>
+
+#include <GLAD/glad.h>
+#include <GLM/glm.hpp>
+#include <GLM/gtc/constants.hpp>
+
+#include "Simulation.h"
+#include "Player.h"
+#include "Level.h"
+#include "Profiler.h"
+
+
+// Public Functions:
+
+void Simulation::Setup(Player * simPlayer, Level * simLevel, double ticksPerSecond, const CollisionWorld * collisionWorld) {
+	player = simPlayer;
+	level = simLevel;
+	world = collisionWorld ? collisionWorld : simLevel;
+	tickDelta = (float)(1.0 / ticksPerSecond);
+
+	previousPlayerPosition = player->GetPosition();
+	previousMoversInstances.resize(level->movers.size());
+	tickTime = std::chrono::steady_clock::now();
+
+	WorldSnapshot initial;
+	initial.tick = 0;
+	initial.tickTime = tickTime;
+	initial.previousPlayerPosition = initial.playerPosition = player->GetPosition();
+	initial.hyper = false;
+	initial.landings = 0;
+	initial.probesApplied = 0;
+	initial.probeTickTime = tickTime;
+
+	// every slot gets room for all movers up front, publishing never reallocates
+	for (size_t i = 0; i < level->movers.size(); i++) {
+		int platform = level->movers[i].platform;
+		previousMoversInstances[i] = level->platformsInstances[platform];
+		initial.movingPlatforms.push_back({platform, previousMoversInstances[i], previousMoversInstances[i]});
+	}
+	snapshots.Reset(initial);
+}
+
+void Simulation::Start() {
+	running = true;
+	thread = std::thread(&Simulation::Run, this);
+}
+
+void Simulation::Stop() {
+	running = false;
+	if (thread.joinable()) thread.join();
+}
+
+void Simulation::QueueInput(unsigned int inputBit, bool pressed, std::chrono::steady_clock::time_point time) {
+	inputQueue.Push({time, inputBit, pressed});
+}
+
+const WorldSnapshot& Simulation::LatestSnapshot() {return snapshots.Read();}
+
+float Simulation::InterpolationAlpha(const WorldSnapshot & snapshot) {
+	// rendering lags the simulation by one tick: blend from the previous tick towards the latest one
+	float sinceTick = std::chrono::duration<float>(std::chrono::steady_clock::now() - snapshot.tickTime).count();
+	return glm::clamp(sinceTick / tickDelta, 0.0f, 1.0f);
+}
+
+
+
+// Private Functions:
+
+void Simulation::Run() {
+	typedef std::chrono::steady_clock Clock;
+	const Clock::duration tickPeriod = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(tickDelta));
+	const int maxCatchUpTicks = 5;
+
+	PROFILE_THREAD_NAME("Simulation");
+	Clock::time_point nextTick = Clock::now();
+	while (running) {
+		// run every tick that is due, but give up catching up after a long stall
+		int ticksRun = 0;
+		while (Clock::now() >= nextTick && ticksRun < maxCatchUpTicks) {
+			tickTime = nextTick;
+			Tick();
+			nextTick += tickPeriod;
+			ticksRun++;
+		}
+		if (ticksRun == maxCatchUpTicks) nextTick = Clock::now() + tickPeriod;
+		if (ticksRun > 0) Publish();
+
+		std::this_thread::sleep_until(nextTick);
+	}
+}
+
+void Simulation::Tick() {
+	PROFILE_SCOPE("Simulation::Tick");
+
+	// Keep the state from before this tick for interpolation
+	previousPlayerPosition = player->GetPosition();
+	MovePlatforms();
+
+	// Apply the input events that happened up to this tick
+	unsigned int inputBits = ConsumeInput();
+	player->ApplyInput(inputBits, tickDelta);
+
+	bool wasOnGround = player->IsOnGround();
+	player->Update(tickDelta, *world);
+	if (player->IsOnGround() && !wasOnGround) landings++;
+	simulationTime += tickDelta;
+	tickCount++;
+}
+
+// Applies queued events stamped up to this tick's time; later ones wait for their own tick.
+// A key pressed and released within one tick still counts as down for that tick,
+// so taps shorter than a tick (or a frame) aren't lost.
+unsigned int Simulation::ConsumeInput() {
+	unsigned int pressedThisTick = 0;
+	while (const InputEvent* event = inputQueue.Peek()) {
+		if (event->time > tickTime) break;
+
+		// probes only record when they were applied
+		if (event->inputBit == INPUT_PROBE) {
+			if (event->pressed) probesApplied++, probeTickTime = std::chrono::steady_clock::now();
+			inputQueue.Pop();
+			continue;
+		}
+
+		if (event->pressed) {
+			heldInput |= event->inputBit;
+			pressedThisTick |= event->inputBit;
+		} else {
+			heldInput &= ~event->inputBit;
+		}
+		inputQueue.Pop();
+	}
+	return heldInput | pressedThisTick;
+}
+
+void Simulation::MovePlatforms() {
+	PROFILE_SCOPE("Simulation::MovePlatforms");
+	for (size_t i = 0; i < level->movers.size(); i++) {
+		const PlatformMover& mover = level->movers[i];
+		previousMoversInstances[i] = level->platformsInstances[mover.platform];
+
+		// ease back and forth between the base position and base + offset
+		float phase = (float)(simulationTime / mover.period) * glm::two_pi<float>();
+		level->MovePlatform(mover.platform, mover.basePosition + mover.offset * (0.5f - 0.5f * glm::cos(phase)));
+	}
+}
+
+void Simulation::Publish() {
+	PROFILE_SCOPE("Simulation::Publish");
+	WorldSnapshot& snapshot = snapshots.WriteBuffer();
+	snapshot.tick = tickCount;
+	snapshot.tickTime = tickTime;
+	snapshot.previousPlayerPosition = previousPlayerPosition;
+	snapshot.playerPosition = player->GetPosition();
+	snapshot.hyper = player->IsHyper();
+	snapshot.landings = landings;
+	snapshot.probesApplied = probesApplied;
+	snapshot.probeTickTime = probeTickTime;
+
+	for (size_t i = 0; i < level->movers.size(); i++) {
+		int platform = level->movers[i].platform;
+		snapshot.movingPlatforms[i] = {platform, previousMoversInstances[i], level->platformsInstances[platform]};
+	}
+	snapshots.Publish();
+}
@@ -0,0 +1,96 @@
+#include <iostream>
+
+#include <GLAD/glad.h>
+#include <GLM/glm.hpp>
+
+#include "StaticLayer.h"
+#include "Profiler.h"
+
+
+// Public Functions:
+
+void StaticLayer::Setup(int width, int height) {
+	viewWidth = width;
+	viewHeight = height;
+	layerWidth = width + 2 * (width / 4);
+	layerHeight = height + 2 * (height / 4);
+	cachedRegion = glm::vec4(0.0f);
+
+	glGenFramebuffers(1, &framebufferId);
+	glGenTextures(1, &colorTextureId);
+	AllocateStorage();
+}
+
+void StaticLayer::Update(int width, int height, glm::vec4 viewRegion) {
+	if (width == 0 || height == 0) return; // minimized, keep the old cache
+
+	// window was resized: the cached texture has the wrong size
+	bool resized = width != viewWidth || height != viewHeight;
+	if (resized) {
+		viewWidth = width;
+		viewHeight = height;
+		layerWidth = width + 2 * (width / 4);
+		layerHeight = height + 2 * (height / 4);
+		AllocateStorage();
+	}
+
+	// view scrolled (partially) out of the cached region: cache around the view again
+	if (resized || viewRegion.x < cachedRegion.x || viewRegion.y < cachedRegion.y || viewRegion.z > cachedRegion.z || viewRegion.w > cachedRegion.w) {
+		glm::vec2 pixelSize = glm::vec2(viewRegion.z - viewRegion.x, viewRegion.w - viewRegion.y) / glm::vec2((float)viewWidth, (float)viewHeight);
+		glm::vec2 margin = glm::vec2((float)((layerWidth - viewWidth) / 2), (float)((layerHeight - viewHeight) / 2)) * pixelSize;
+		cachedRegion = glm::vec4(glm::vec2(viewRegion.x, viewRegion.y) - margin, glm::vec2(viewRegion.z, viewRegion.w) + margin);
+		dirty = true;
+	}
+}
+
+void StaticLayer::Invalidate() {dirty = true;}
+bool StaticLayer::IsDirty() {return dirty;}
+
+
+void StaticLayer::BeginCapture() {
+	glBindFramebuffer(GL_FRAMEBUFFER, framebufferId);
+	glViewport(0, 0, layerWidth, layerHeight);
+}
+
+void StaticLayer::EndCapture() {
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glViewport(0, 0, viewWidth, viewHeight);
+	dirty = false;
+}
+
+void StaticLayer::Composite(glm::vec4 viewRegion) {
+	PROFILE_SCOPE("StaticLayer::Composite");
+
+	// where the view's lower left corner sits in the layer, in whole pixels
+	glm::vec2 pixelSize = glm::vec2(viewRegion.z - viewRegion.x, viewRegion.w - viewRegion.y) / glm::vec2((float)viewWidth, (float)viewHeight);
+	int sourceX = (int)glm::round((viewRegion.x - cachedRegion.x) / pixelSize.x);
+	int sourceY = (int)glm::round((viewRegion.y - cachedRegion.y) / pixelSize.y);
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, framebufferId);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+	glBlitFramebuffer(sourceX, sourceY, sourceX + viewWidth, sourceY + viewHeight, 0, 0, viewWidth, viewHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void StaticLayer::Delete() {
+	glDeleteFramebuffers(1, &framebufferId);
+	glDeleteTextures(1, &colorTextureId);
+}
+
+
+
+// Private Functions:
+
+void StaticLayer::AllocateStorage() {
+	glBindTexture(GL_TEXTURE_2D, colorTextureId);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, layerWidth, layerHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, framebufferId);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTextureId, 0);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "ERROR::FRAMEBUFFER: Static layer framebuffer is not complete" << std::endl;
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
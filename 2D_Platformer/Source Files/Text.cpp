@@ -4,81 +4,31 @@
 #include <GLFW/glfw3.h>
 #include <GLM/glm.hpp>
 #include <GLM/gtc/matrix_transform.hpp>
-#include <ft2build.h>
-#include FT_FREETYPE_H
 
 #include "Text.h"
 #include "ShaderProgram.h"
+#include "FontAtlas.h"
+#include "Profiler.h"
 
 
-// Constructor
+// Public Functions:
 
-Text::Text(unsigned int width, unsigned int height, const char * vrtxShaderPath, const char * frgmtShaderPath, unsigned int SCR_WIDTH, unsigned int SCR_HEIGHT) {
+void Text::Setup(const ShaderSources & shaderSources, unsigned int SCR_WIDTH, unsigned int SCR_HEIGHT) {
 	glEnable(GL_CULL_FACE);
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-	shaderProgramId.Setup(vrtxShaderPath, frgmtShaderPath);
+	shaderProgramId.Setup(shaderSources);
 	glm::mat4 projection = glm::ortho(0.0f, static_cast<GLfloat>(SCR_WIDTH), 0.0f, static_cast<GLfloat>(SCR_HEIGHT));
 	shaderProgramId.activate();
 	shaderProgramId.setMat4Uniform("projection", projection);
 
 
-	// initialize library
-	FT_Library ft;
-	if (FT_Init_FreeType(&ft)){
-		std::cout << "ERROR::FREETYPE: Could not init FreeType Library" << std::endl;
-		std::cin.get();
-		return;
-	}
-
-	// load font
-	FT_Face face;
-	if (FT_New_Face(ft, "Resources/fonts/arial.ttf", 0, &face)) {
-		std::cout << "ERROR::FREETYPE: Failed to load font" << std::endl;
-		std::cin.get();
-		return;
-	}
-
-	// set width and height of characters
-	FT_Set_Pixel_Sizes(face, width, height);
-
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // Disable byte-alignment restriction
-
-
-    // loop over all characters and save their texture and metrics for later use
-	for (GLubyte c = 0; c < 128; c++) {
-		// Load character glyph 
-		if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
-			std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
-			continue;
-		}
-
-		// generate current character texture
-		GLuint textureId;
-		GenerateCharTexture(face, textureId);
-
-		// Set texture options
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		
-		// Now store character for later use
-		AddToMap(face, textureId, c);
-	}
-
-	glBindTexture(GL_TEXTURE_2D, 0);
-	FT_Done_Face(face);
-	FT_Done_FreeType(ft);
-
-
 	glGenVertexArrays(1, &vaoId);
 	glBindVertexArray(vaoId);
 
 	glGenBuffers(1, &vboId);
 	glBindBuffer(GL_ARRAY_BUFFER, vboId);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
 
 	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), 0);
 	glEnableVertexAttribArray(0);
@@ -87,83 +37,107 @@ Text::Text(unsigned int width, unsigned int height, const char * vrtxShaderPath,
 	glBindVertexArray(0);
 }
 
+// The whole font is one texture, uploaded straight from the baked file
+void Text::UploadAtlas(const FontAtlas & atlas) {
+	const CompiledFontHeader& header = *atlas.header;
 
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // Disable byte-alignment restriction
+	glGenTextures(1, &atlasTextureId);
+	glBindTexture(GL_TEXTURE_2D, atlasTextureId);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, header.atlasWidth, header.atlasHeight, 0, GL_RED, GL_UNSIGNED_BYTE, atlas.pixels);
+
+	// Set texture options (glyphs are padded in the atlas, so linear filtering doesn't bleed)
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glBindTexture(GL_TEXTURE_2D, 0);
 
-// Public Functions:
+	// Metrics for later use
+	for (uint32_t i = 0; i < header.numOfGlyphs; i++) {
+		const CompiledGlyph& glyph = atlas.glyphs[i];
+		if (glyph.character >= 128) continue;
+
+		Character& character = characters[glyph.character];
+		character.atlasRegion = glm::vec4(
+			(float)glyph.atlasX / header.atlasWidth, (float)glyph.atlasY / header.atlasHeight,
+			(float)(glyph.atlasX + glyph.width) / header.atlasWidth, (float)(glyph.atlasY + glyph.height) / header.atlasHeight);
+		character.Size = glm::ivec2(glyph.width, glyph.height);
+		character.Bearing = glm::ivec2(glyph.bearingX, glyph.bearingY);
+		character.Advance = (GLuint)glyph.advance;
+		character.present = true;
+	}
 
-void Text::RenderText(std::string text, GLfloat x, GLfloat y, GLfloat scale, glm::vec3 color) {
-	// Activate corresponding render state	
-	shaderProgramId.activate();
-	glBindVertexArray(vaoId);
+	for (uint32_t i = 0; i < header.numOfKerningPairs; i++) {
+		const CompiledKerningPair& pair = atlas.kerningPairs[i];
+		if (pair.left < 128 && pair.right < 128) kerning[std::make_pair((GLchar)pair.left, (GLchar)pair.right)] = pair.advance;
+	}
+}
 
-	shaderProgramId.setVec3Uniform("textColor", color.x, color.y, color.z);
+void Text::RenderText(const char* text, GLfloat x, GLfloat y, GLfloat scale, glm::vec3 color) {
+	PROFILE_SCOPE("Text::RenderText");
+	if (atlasTextureId == 0) return; // font not loaded yet
+
+	// Build one quad per character
+	vertices.clear();
+	GLchar previous = 0;
+	for (const char* c = text; *c != '\0'; c++) {
+		if ((unsigned char)*c >= 128 || !characters[(int)*c].present) continue;
+		const Character& ch = characters[(int)*c];
 
-	// Iterate through all characters of the desired text
-	std::string::const_iterator c;
-	for (c = text.begin(); c != text.end(); c++) {
-		Character ch = CharactersMap[*c];
+		if (previous != 0 && !kerning.empty()) {
+			std::map<std::pair<GLchar, GLchar>, int>::const_iterator pair = kerning.find(std::make_pair(previous, *c));
+			if (pair != kerning.end()) x += (pair->second >> 6) * scale;
+		}
+		previous = *c;
 
 		GLfloat xpos = x + ch.Bearing.x * scale;
 		GLfloat ypos = y - (ch.Size.y - ch.Bearing.y) * scale;
 
 		GLfloat w = ch.Size.x * scale;
 		GLfloat h = ch.Size.y * scale;
-		// Update VBO for each character
-		GLfloat vertices[6][4] = {
-		{xpos,     ypos + h, 0.0, 0.0},            
-		{xpos,     ypos,     0.0, 1.0},
-		{xpos + w, ypos,     1.0, 1.0},
-
-		{xpos,     ypos + h, 0.0, 0.0},
-		{xpos + w, ypos,     1.0, 1.0},
-		{xpos + w, ypos + h, 1.0, 0.0}           
+		GLfloat left = ch.atlasRegion.x, top = ch.atlasRegion.y, right = ch.atlasRegion.z, bottom = ch.atlasRegion.w;
+		GLfloat quad[6][4] = {
+		{xpos,     ypos + h, left,  top},
+		{xpos,     ypos,     left,  bottom},
+		{xpos + w, ypos,     right, bottom},
+
+		{xpos,     ypos + h, left,  top},
+		{xpos + w, ypos,     right, bottom},
+		{xpos + w, ypos + h, right, top}
 		};
-
-		// Render glyph texture over quad
-		glBindTexture(GL_TEXTURE_2D, ch.textureId);
-
-		// Update content of VBO memory
-		glBindBuffer(GL_ARRAY_BUFFER, vboId);
-		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices); 
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-		// Render quad
-		glDrawArrays(GL_TRIANGLES, 0, 6);
+		vertices.insert(vertices.end(), &quad[0][0], &quad[0][0] + 6 * 4);
 
 		// Now advance cursors for next glyph (note that advance is number of 1/64 pixels)
 		x += (ch.Advance >> 6) * scale; // Bitshift by 6 to get value in pixels (2^6 = 64)
 	}
+	if (vertices.empty()) return;
 
-	glBindVertexArray(0);
-	glBindTexture(GL_TEXTURE_2D, 0);
-}
-
+	// Activate corresponding render state	
+	shaderProgramId.activate();
+	shaderProgramId.setVec3Uniform("textColor", color.x, color.y, color.z);
+	glBindVertexArray(vaoId);
+	glBindTexture(GL_TEXTURE_2D, atlasTextureId);
 
+	// Update content of VBO memory, growing it if the string is longer than any before
+	glBindBuffer(GL_ARRAY_BUFFER, vboId);
+	unsigned int numOfVertices = (unsigned int)vertices.size() / 4;
+	if (numOfVertices > vertexCapacity) {
+		vertexCapacity = numOfVertices;
+		glBufferData(GL_ARRAY_BUFFER, vertexCapacity * 4 * sizeof(GLfloat), NULL, GL_DYNAMIC_DRAW);
+	}
+	glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(GLfloat), vertices.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-// Private Functions:
+	// Render all quads at once
+	glDrawArrays(GL_TRIANGLES, 0, numOfVertices);
 
-void Text::AddToMap(FT_Face face, GLuint textureId, char c) {
-	Character character = {
-		textureId, 
-		glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-		glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-		(GLuint)(face->glyph->advance.x)
-	};
-	CharactersMap.insert(std::pair<GLchar, Character>(c, character));
+	glBindVertexArray(0);
+	glBindTexture(GL_TEXTURE_2D, 0);
 }
 
-void Text::GenerateCharTexture(FT_Face face, GLuint &textureId) {
-	glGenTextures(1, &textureId);
-	glBindTexture(GL_TEXTURE_2D, textureId);
-	glTexImage2D(
-		GL_TEXTURE_2D,
-		0,
-		GL_RED,
-		face->glyph->bitmap.width,
-		face->glyph->bitmap.rows,
-		0,
-		GL_RED,
-		GL_UNSIGNED_BYTE,
-		face->glyph->bitmap.buffer
-	);
+void Text::Delete() {
+	glDeleteVertexArrays(1, &vaoId);
+	glDeleteBuffers(1, &vboId);
+	glDeleteTextures(1, &atlasTextureId);
 }
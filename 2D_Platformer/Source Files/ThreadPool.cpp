@@ -0,0 +1,95 @@
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "ThreadPool.h"
+#include "Profiler.h"
+
+
+// Public Functions:
+
+void ThreadPool::Setup(unsigned int numOfThreads) {
+	if (numOfThreads == 0) {
+		unsigned int cores = std::thread::hardware_concurrency(); // 0 when unknown
+		numOfThreads = cores > 1 ? cores - 1 : 1;
+	}
+
+	stopping = false;
+	for (unsigned int i = 0; i < numOfThreads; i++) workers.emplace_back(&ThreadPool::Work, this);
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.push_back(std::move(task));
+	}
+	wakeUp.notify_one();
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)> & body) {
+	if (count == 0) return;
+	if (chunkSize == 0) chunkSize = 1;
+
+	// Shared with the helper tasks, which may only get to run after this call has returned
+	struct Batch {
+		std::atomic<size_t> nextIndex {0};
+		std::atomic<size_t> doneCount {0};
+		std::mutex mutex;
+		std::condition_variable finished;
+	};
+	std::shared_ptr<Batch> batch = std::make_shared<Batch>();
+	const std::function<void(size_t, size_t)>* bodyPointer = &body;
+
+	// Grabs chunks until none are left; body is only touched while chunks remain, so late helpers never see it dangling
+	auto runChunks = [batch, bodyPointer, count, chunkSize]() {
+		size_t begin;
+		while ((begin = batch->nextIndex.fetch_add(chunkSize)) < count) {
+			size_t end = begin + chunkSize < count ? begin + chunkSize : count;
+			(*bodyPointer)(begin, end);
+			if (batch->doneCount.fetch_add(end - begin) + (end - begin) == count) {
+				std::lock_guard<std::mutex> lock(batch->mutex);
+				batch->finished.notify_all();
+			}
+		}
+	};
+
+	size_t numOfChunks = (count + chunkSize - 1) / chunkSize;
+	size_t numOfHelpers = numOfChunks - 1 < workers.size() ? numOfChunks - 1 : workers.size();
+	for (size_t i = 0; i < numOfHelpers; i++) Submit(runChunks);
+	runChunks();
+
+	std::unique_lock<std::mutex> lock(batch->mutex);
+	batch->finished.wait(lock, [&batch, count] {return batch->doneCount.load() == count;});
+}
+
+void ThreadPool::Shutdown() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wakeUp.notify_all();
+
+	for (std::thread& worker : workers) worker.join();
+	workers.clear();
+}
+
+
+
+// Private Functions:
+
+void ThreadPool::Work() {
+	PROFILE_THREAD_NAME("Worker");
+	while (true) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wakeUp.wait(lock, [this] {return stopping || !tasks.empty();});
+			if (tasks.empty()) return; // stopping and drained
+			task = std::move(tasks.front());
+			tasks.pop_front();
+		}
+		PROFILE_SCOPE("ThreadPool::Task");
+		task();
+	}
+}
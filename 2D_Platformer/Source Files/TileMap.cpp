@@ -0,0 +1,270 @@
+#include <string>
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include <GLM/glm.hpp>
+
+#include "TileMap.h"
+#include "FileSystem.h"
+
+
+// Tile map files are plain text: a few commands, '#' starts a comment,
+// then after a "map" line one line per row of cells, top row first:
+//   cell   <size>
+//   origin <x> <y>       bottom left corner
+//   spawn  <x> <y>
+//   map
+//   ....##....
+//   --..##..--            '#' solid, '-' one-way, anything else empty
+// Rows may have different lengths, the map is as wide as the longest.
+
+static uint64_t AlignOffset(uint64_t offset) {
+	return (offset + 63) / 64 * 64;
+}
+
+static int CountTrailingZeros(uint32_t bits) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, bits);
+	return (int)index;
+#else
+	return __builtin_ctz(bits);
+#endif
+}
+
+static Tile_Type TileFromChar(char c) {
+	if (c == '#') return TILE_SOLID;
+	if (c == '-') return TILE_ONE_WAY;
+	return TILE_EMPTY;
+}
+
+
+// Public Functions:
+
+bool TileMap::Load(const char * path) {
+	FileData file;
+	if (!FileSystem::ReadFile(path, file)) {
+		std::cout << "ERROR::TILE_MAP::FILE_NOT_SUCCESSFULLY_READ: " << path << std::endl;
+		return false;
+	}
+	std::istringstream source(file.Text());
+
+	std::string line;
+	int lineNumber = 0;
+	bool inMap = false;
+	std::vector<std::string> rows;
+	while (std::getline(source, line)) {
+		lineNumber++;
+		if (!line.empty() && line.back() == '\r') line.pop_back();
+		if (inMap) {
+			rows.push_back(line);
+			continue;
+		}
+
+		std::istringstream words(line.substr(0, line.find('#')));
+		std::string command;
+		if (!(words >> command)) continue; // blank or comment line
+
+		bool valid = true;
+		if (command == "cell")        valid = (bool)(words >> cellSize) && cellSize > 0.0f;
+		else if (command == "origin") valid = (bool)(words >> origin.x >> origin.y);
+		else if (command == "spawn")  valid = (bool)(words >> spawnPoint.x >> spawnPoint.y);
+		else if (command == "map")    inMap = true;
+		else valid = false;
+
+		if (!valid) {
+			std::cout << "ERROR::TILE_MAP::INVALID_LINE: " << path << ":" << lineNumber << std::endl;
+			return false;
+		}
+	}
+
+	size_t longest = 0;
+	for (const std::string& row : rows) longest = glm::max(longest, row.size());
+	Resize((int)longest, (int)rows.size());
+
+	for (int y = 0; y < height; y++) {
+		const std::string& row = rows[height - 1 - y];
+		for (int x = 0; x < (int)row.size(); x++) SetCell(x, y, TileFromChar(row[x]));
+	}
+	return true;
+}
+
+bool TileMap::LoadCompiled(const char * path) {
+	FileData file;
+	if (!FileSystem::ReadFile(path, file)) {
+		std::cout << "ERROR::TILE_MAP::FILE_NOT_SUCCESSFULLY_READ: " << path << std::endl;
+		return false;
+	}
+
+	// Validate before trusting any offset
+	const CompiledTileMapHeader* header = (const CompiledTileMapHeader*)file.data;
+	if (file.size < sizeof(CompiledTileMapHeader) || std::memcmp(header->magic, "TMAP", 4) != 0 || header->version != compiledTileMapVersion
+		|| !(header->cellSize > 0.0f) || !std::isfinite(header->cellSize) || header->width > INT32_MAX || header->height > INT32_MAX) {
+		std::cout << "ERROR::TILE_MAP::INVALID_FILE: " << path << std::endl;
+		return false;
+	}
+	uint64_t numOfChunks = (uint64_t)((header->width + tileChunkSize - 1) / tileChunkSize) * ((header->height + tileChunkSize - 1) / tileChunkSize);
+	if (!SectionInside(header->chunksOffset, numOfChunks, sizeof(TileChunk), file.size)) {
+		std::cout << "ERROR::TILE_MAP::TRUNCATED_FILE: " << path << std::endl;
+		return false;
+	}
+
+	cellSize = header->cellSize;
+	origin = glm::vec2(header->originX, header->originY);
+	spawnPoint = glm::vec2(header->spawnX, header->spawnY);
+	Resize((int)header->width, (int)header->height);
+	std::memcpy(chunks.data(), file.data + header->chunksOffset, chunks.size() * sizeof(TileChunk));
+	return true;
+}
+
+bool TileMap::SaveCompiled(const char * path) const {
+	CompiledTileMapHeader header = {};
+	std::memcpy(header.magic, "TMAP", 4);
+	header.version = compiledTileMapVersion;
+	header.width = (uint32_t)width;
+	header.height = (uint32_t)height;
+	header.cellSize = cellSize;
+	header.originX = origin.x;
+	header.originY = origin.y;
+	header.spawnX = spawnPoint.x;
+	header.spawnY = spawnPoint.y;
+	header.chunksOffset = AlignOffset(sizeof(CompiledTileMapHeader));
+	uint64_t fileSize = header.chunksOffset + chunks.size() * sizeof(TileChunk);
+
+	std::vector<unsigned char> file((size_t)fileSize, 0);
+	std::memcpy(&file[0], &header, sizeof(header));
+	if (!chunks.empty()) std::memcpy(&file[(size_t)header.chunksOffset], chunks.data(), chunks.size() * sizeof(TileChunk));
+
+	std::ofstream fileStream(path, std::ios::binary);
+	fileStream.write((const char*)file.data(), file.size());
+	if (!fileStream) {
+		std::cout << "ERROR::TILE_MAP::FILE_NOT_SUCCESSFULLY_WRITTEN: " << path << std::endl;
+		return false;
+	}
+	return true;
+}
+
+void TileMap::Resize(int widthInCells, int heightInCells) {
+	width = glm::max(widthInCells, 0);
+	height = glm::max(heightInCells, 0);
+	chunksX = (width + tileChunkSize - 1) / tileChunkSize;
+	chunksY = (height + tileChunkSize - 1) / tileChunkSize;
+	chunks.assign((size_t)chunksX * chunksY, TileChunk());
+}
+
+
+Tile_Type TileMap::GetCell(int x, int y) const {
+	if (x < 0 || y < 0 || x >= width || y >= height) return TILE_EMPTY;
+	const TileChunk& chunk = chunks[(y / tileChunkSize) * chunksX + x / tileChunkSize];
+	return (Tile_Type)((chunk.rows[y % tileChunkSize] >> (2 * (x % tileChunkSize))) & 3);
+}
+
+void TileMap::SetCell(int x, int y, Tile_Type type) {
+	if (x < 0 || y < 0 || x >= width || y >= height) return;
+	TileChunk& chunk = chunks[(y / tileChunkSize) * chunksX + x / tileChunkSize];
+	uint64_t& row = chunk.rows[y % tileChunkSize];
+	int shift = 2 * (x % tileChunkSize);
+	row = (row & ~((uint64_t)3 << shift)) | ((uint64_t)type << shift);
+}
+
+glm::ivec2 TileMap::CellAt(glm::vec2 position) const {
+	return glm::ivec2(glm::floor((position - origin) / cellSize));
+}
+
+Collider TileMap::CellBounds(int x, int y) const {
+	return {origin.x + x * cellSize, origin.x + (x + 1) * cellSize, origin.y + y * cellSize, origin.y + (y + 1) * cellSize};
+}
+
+
+Collider TileMap::Bounds() const {
+	return {origin.x, origin.x + width * cellSize, origin.y, origin.y + height * cellSize};
+}
+
+// Runs of neighbouring cells come back as one collider, so a player rolling over
+// a floor of cells never catches on the seams between them: solid runs merge
+// along rows and then with identical runs in the rows below, one-way runs only
+// along rows (they only have a top). Solid colliders come first.
+// Rows are scanned a chunk wide at a time, empty stretches cost one test per 32 cells.
+// Past maxColliders runs are only counted, unmerged, so the count may be a few more than
+// a big enough buffer ends up holding.
+int TileMap::QueryColliders(glm::vec2 center, float reach, float velocityY, Collider * colliders, int maxColliders) const {
+	glm::ivec2 lowest = glm::max(CellAt(center - glm::vec2(reach)), glm::ivec2(0));
+	glm::ivec2 highest = glm::min(CellAt(center + glm::vec2(reach)), glm::ivec2(width - 1, height - 1));
+	int count = 0;
+
+	for (int y = lowest.y; y <= highest.y; y++) {
+		int x = NextCell(y, lowest.x, highest.x, TILE_SOLID, true);
+		while (x <= highest.x) {
+			int end = NextCell(y, x, highest.x, TILE_SOLID, false) - 1;
+			Collider run = {CellBounds(x, y).leftSide, CellBounds(end, y).rightSide, CellBounds(x, y).lowerSide, CellBounds(x, y).upperSide};
+
+			bool merged = false;
+			for (int i = 0; i < glm::min(count, maxColliders) && !merged; i++) {
+				Collider& below = colliders[i];
+				if (below.leftSide == run.leftSide && below.rightSide == run.rightSide && below.upperSide == run.lowerSide) below.upperSide = run.upperSide, merged = true;
+			}
+			if (!merged && count < maxColliders) colliders[count] = run;
+			if (!merged) count++;
+			x = NextCell(y, end + 1, highest.x, TILE_SOLID, true);
+		}
+	}
+
+	// one-way cells only hold up a player coming down on them from above
+	if (velocityY > 0.0f) return count;
+	for (int y = lowest.y; y <= highest.y; y++) {
+		if (center.y < CellBounds(0, y).upperSide) continue;
+
+		int x = NextCell(y, lowest.x, highest.x, TILE_ONE_WAY, true);
+		while (x <= highest.x) {
+			int end = NextCell(y, x, highest.x, TILE_ONE_WAY, false) - 1;
+			if (count < maxColliders) colliders[count] = {CellBounds(x, y).leftSide, CellBounds(end, y).rightSide, CellBounds(x, y).lowerSide, CellBounds(x, y).upperSide};
+			count++;
+			x = NextCell(y, end + 1, highest.x, TILE_ONE_WAY, true);
+		}
+	}
+	return count;
+}
+
+
+
+
+// Private Functions:
+
+// Bit i is set when cell (chunkX * 32 + i, y) is of the given type
+uint32_t TileMap::RowBits(int chunkX, int y, Tile_Type type) const {
+	uint64_t row = chunks[(y / tileChunkSize) * chunksX + chunkX].rows[y % tileChunkSize];
+	if (row == 0) return type == TILE_EMPTY ? ~0u : 0u;
+	uint64_t low = row & 0x5555555555555555ull, high = (row >> 1) & 0x5555555555555555ull;
+	uint64_t bits = type == TILE_SOLID ? low & ~high : type == TILE_ONE_WAY ? high & ~low : ~(low | high) & 0x5555555555555555ull;
+
+	// squeeze every other bit together
+	bits = (bits | (bits >> 1))  & 0x3333333333333333ull;
+	bits = (bits | (bits >> 2))  & 0x0F0F0F0F0F0F0F0Full;
+	bits = (bits | (bits >> 4))  & 0x00FF00FF00FF00FFull;
+	bits = (bits | (bits >> 8))  & 0x0000FFFF0000FFFFull;
+	bits = (bits | (bits >> 16)) & 0x00000000FFFFFFFFull;
+	return (uint32_t)bits;
+}
+
+// First cell in [from, to] of row y that is (or with isType false, isn't) of type, to + 1 when there is none
+int TileMap::NextCell(int y, int from, int to, Tile_Type type, bool isType) const {
+	for (int chunkX = from / tileChunkSize; chunkX <= to / tileChunkSize; chunkX++) {
+		int chunkStart = chunkX * tileChunkSize;
+		uint32_t bits = RowBits(chunkX, y, type);
+		if (!isType) bits = ~bits;
+		if (from > chunkStart) bits &= ~0u << (from - chunkStart);
+		if (bits == 0) continue;
+
+		int cell = chunkStart + CountTrailingZeros(bits);
+		return cell <= to ? cell : to + 1;
+	}
+	return to + 1;
+}
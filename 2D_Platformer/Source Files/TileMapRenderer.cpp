@@ -0,0 +1,160 @@
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include <GLAD/glad.h>
+#include <GLM/glm.hpp>
+
+#include "TileMapRenderer.h"
+#include "TileMap.h"
+#include "ShaderProgram.h"
+#include "Profiler.h"
+
+
+// Public Functions:
+
+void TileMapRenderer::Setup(const ShaderSources & shaderSources) {
+	// Assign shaders to shader program, the fragment shader tells one-way cells apart by the enum's value
+	shaderProgram.Setup(shaderSources, {"TILE_ONE_WAY " + std::to_string((int)TILE_ONE_WAY)});
+
+	// a full chunk of alternating cells is the most a bake ever needs
+	vertices.reserve(tileChunkSize * tileChunkSize * 4);
+	indices.reserve(tileChunkSize * tileChunkSize * 6);
+}
+
+void TileMapRenderer::Upload(const TileMap & map) {
+	DeleteMeshes();
+	tileMap = &map;
+	chunksX = (map.Width() + tileChunkSize - 1) / tileChunkSize;
+	chunksY = (map.Height() + tileChunkSize - 1) / tileChunkSize;
+	meshes.assign(chunksX * chunksY, ChunkMesh());
+}
+
+void TileMapRenderer::MarkDirty(int cellX, int cellY) {
+	if (tileMap == nullptr || cellX < 0 || cellY < 0 || cellX >= tileMap->Width() || cellY >= tileMap->Height()) return;
+	meshes[cellY / tileChunkSize * chunksX + cellX / tileChunkSize].dirty = true;
+}
+
+void TileMapRenderer::Bake(int chunkX, int chunkY) {
+	if (chunkX < 0 || chunkY < 0 || chunkX >= chunksX || chunkY >= chunksY) return;
+	ChunkMesh& mesh = meshes[chunkY * chunksX + chunkX];
+	if (mesh.dirty) BakeMesh(chunkX, chunkY, mesh);
+}
+
+void TileMapRenderer::BakeRegion(glm::vec4 region) {
+	glm::ivec2 lowest, highest;
+	if (!ChunkRange(region, lowest, highest)) return;
+	for (int chunkY = lowest.y; chunkY <= highest.y; chunkY++)
+		for (int chunkX = lowest.x; chunkX <= highest.x; chunkX++) Bake(chunkX, chunkY);
+}
+
+void TileMapRenderer::Draw(glm::vec4 region, const glm::mat4& viewProjection) {
+	PROFILE_SCOPE("TileMapRenderer::Draw");
+	drawn = 0;
+	glm::ivec2 lowest, highest;
+	if (!ChunkRange(region, lowest, highest)) return;
+
+	shaderProgram.activate();
+	shaderProgram.setMat4Uniform("viewProjection", viewProjection);
+
+	for (int chunkY = lowest.y; chunkY <= highest.y; chunkY++) {
+		for (int chunkX = lowest.x; chunkX <= highest.x; chunkX++) {
+			ChunkMesh& mesh = meshes[chunkY * chunksX + chunkX];
+			if (mesh.dirty) BakeMesh(chunkX, chunkY, mesh); // not baked on load
+			if (mesh.indexCount == 0) continue;
+
+			glBindVertexArray(mesh.vaoId);
+			glDrawElements(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_SHORT, 0);
+			drawn++;
+		}
+	}
+
+	shaderProgram.deactivate();
+	glBindVertexArray(0);
+}
+
+void TileMapRenderer::DeleteVAO() {
+	DeleteMeshes();
+}
+
+
+
+
+// Private Functions:
+
+// Chunks under the region's corners, everything outside them is culled
+bool TileMapRenderer::ChunkRange(glm::vec4 region, glm::ivec2 & lowest, glm::ivec2 & highest) const {
+	if (tileMap == nullptr || meshes.empty()) return false;
+
+	Collider bounds = tileMap->Bounds();
+	if (region.z < bounds.leftSide || region.x > bounds.rightSide || region.w < bounds.lowerSide || region.y > bounds.upperSide) return false;
+
+	lowest = glm::max(tileMap->CellAt(glm::vec2(region.x, region.y)), glm::ivec2(0)) / tileChunkSize;
+	highest = glm::min(tileMap->CellAt(glm::vec2(region.z, region.w)), glm::ivec2(tileMap->Width() - 1, tileMap->Height() - 1)) / tileChunkSize;
+	return true;
+}
+
+// Runs of same type cells along a row become one quad
+void TileMapRenderer::BakeMesh(int chunkX, int chunkY, ChunkMesh & mesh) {
+	PROFILE_SCOPE("TileMapRenderer::Bake");
+	int firstX = chunkX * tileChunkSize, endX = glm::min(firstX + tileChunkSize, tileMap->Width());
+	int firstY = chunkY * tileChunkSize, endY = glm::min(firstY + tileChunkSize, tileMap->Height());
+
+	vertices.clear();
+	indices.clear();
+	for (int y = firstY; y < endY; y++) {
+		for (int x = firstX; x < endX;) {
+			Tile_Type type = tileMap->GetCell(x, y);
+			int end = x + 1;
+			while (end < endX && tileMap->GetCell(end, y) == type) end++;
+
+			if (type != TILE_EMPTY) {
+				Collider run = {tileMap->CellBounds(x, y).leftSide, tileMap->CellBounds(end - 1, y).rightSide, tileMap->CellBounds(x, y).lowerSide, tileMap->CellBounds(x, y).upperSide};
+				uint16_t first = (uint16_t)vertices.size();
+				vertices.push_back({glm::vec2(run.leftSide, run.lowerSide), (float)type});
+				vertices.push_back({glm::vec2(run.rightSide, run.lowerSide), (float)type});
+				vertices.push_back({glm::vec2(run.rightSide, run.upperSide), (float)type});
+				vertices.push_back({glm::vec2(run.leftSide, run.upperSide), (float)type});
+				for (uint16_t corner : {0, 1, 3, 1, 2, 3}) indices.push_back(first + corner);
+			}
+			x = end;
+		}
+	}
+	mesh.indexCount = (int)indices.size();
+	mesh.dirty = false;
+
+	if (mesh.vaoId == 0) {
+		glGenVertexArrays(1, &mesh.vaoId);
+		glGenBuffers(1, &mesh.vbo);
+		glGenBuffers(1, &mesh.ebo);
+
+		glBindVertexArray(mesh.vaoId);
+		glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(TileVertex), (void*)offsetof(TileVertex, position));
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(TileVertex), (void*)offsetof(TileVertex, type));
+		glEnableVertexAttribArray(1);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo);
+	} else {
+		glBindVertexArray(mesh.vaoId);
+		glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+	}
+
+	// static until the next edit of this chunk
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(TileVertex), vertices.data(), GL_STATIC_DRAW);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint16_t), indices.data(), GL_STATIC_DRAW);
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void TileMapRenderer::DeleteMeshes() {
+	for (ChunkMesh& mesh : meshes) {
+		if (mesh.vaoId == 0) continue;
+		glDeleteVertexArrays(1, &mesh.vaoId);
+		glDeleteBuffers(1, &mesh.vbo);
+		glDeleteBuffers(1, &mesh.ebo);
+	}
+	meshes.clear();
+}
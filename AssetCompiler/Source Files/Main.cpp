@@ -0,0 +1,300 @@
+#include <string>
+#include <vector>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include "Level.h"
+#include "FileSystem.h"
+#include "FontAtlas.h"
+#include "Lz4.h"
+#include "NavGraph.h"
+#include "PlayerPhysics.h"
+#include "ThreadPool.h"
+#include "TileMap.h"
+
+// Offline asset compiler: turns the human-editable assets into the formats the
+// game loads at runtime without parsing.
+//   AssetCompiler level <input.lvl> <output.lvlb>
+//   AssetCompiler font <input.ttf> <pixel height> <output.fnta>
+//   AssetCompiler pack <output.pak> <root directory> <subdirectory>...
+//   AssetCompiler nav <input.lvl> <player radius> <ticks per second> <output.navb>
+//   AssetCompiler tiles <input.tiles> <output.tmap>
+
+// Functions
+void PrintUsage();
+bool CompileLevel(const char* inputPath, const char* outputPath);
+bool BakeFont(const char* inputPath, unsigned int pixelHeight, const char* outputPath);
+bool BuildPack(const char* outputPath, const char* rootPath, const std::vector<std::string>& subdirectories);
+bool BuildNavGraph(const char* inputPath, float radius, double ticksPerSecond, const char* outputPath);
+bool CompileTileMap(const char* inputPath, const char* outputPath);
+
+
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		PrintUsage();
+		return 1;
+	}
+
+	std::string command = argv[1];
+	if (command == "level" && argc == 4) return CompileLevel(argv[2], argv[3]) ? 0 : 1;
+	if (command == "font" && argc == 5) return BakeFont(argv[2], (unsigned int)std::stoul(argv[3]), argv[4]) ? 0 : 1;
+	if (command == "pack" && argc >= 5) return BuildPack(argv[2], argv[3], std::vector<std::string>(argv + 4, argv + argc)) ? 0 : 1;
+	if (command == "nav" && argc == 6) return BuildNavGraph(argv[2], std::stof(argv[3]), std::stod(argv[4]), argv[5]) ? 0 : 1;
+	if (command == "tiles" && argc == 4) return CompileTileMap(argv[2], argv[3]) ? 0 : 1;
+
+	PrintUsage();
+	return 1;
+}
+
+
+// User-defined Functions:
+
+void PrintUsage() {
+	std::cout << "Usage:" << std::endl;
+	std::cout << "  AssetCompiler level <input.lvl> <output.lvlb>" << std::endl;
+	std::cout << "  AssetCompiler font <input.ttf> <pixel height> <output.fnta>" << std::endl;
+	std::cout << "  AssetCompiler pack <output.pak> <root directory> <subdirectory>..." << std::endl;
+	std::cout << "  AssetCompiler nav <input.lvl> <player radius> <ticks per second> <output.navb>" << std::endl;
+	std::cout << "  AssetCompiler tiles <input.tiles> <output.tmap>" << std::endl;
+}
+
+bool CompileLevel(const char* inputPath, const char* outputPath) {
+	Level level;
+	if (!level.Load(inputPath)) return false;
+	if (!level.SaveCompiled(outputPath)) return false;
+
+	std::cout << "Compiled " << level.NumOfPlatforms() << " platforms, " << level.movers.size() << " movers -> " << outputPath << std::endl;
+	return true;
+}
+
+// Rasterizes the printable ASCII glyphs and packs them into one atlas with
+// shelf packing (tallest glyphs first), 1 pixel apart so linear filtering
+// doesn't bleed between neighbours. Kerning comes from the font's kern table.
+bool BakeFont(const char* inputPath, unsigned int pixelHeight, const char* outputPath) {
+	const uint32_t firstCharacter = 32, lastCharacter = 126;
+	const int padding = 1;
+
+	FT_Library ft;
+	if (FT_Init_FreeType(&ft)) {
+		std::cout << "ERROR::FREETYPE: Could not init FreeType Library" << std::endl;
+		return false;
+	}
+
+	FT_Face face;
+	if (FT_New_Face(ft, inputPath, 0, &face)) {
+		std::cout << "ERROR::FREETYPE: Failed to load font: " << inputPath << std::endl;
+		FT_Done_FreeType(ft);
+		return false;
+	}
+	FT_Set_Pixel_Sizes(face, 0, pixelHeight);
+
+	// Rasterize
+	std::vector<CompiledGlyph> glyphs;
+	std::vector<std::vector<unsigned char>> bitmaps;
+	for (uint32_t c = firstCharacter; c <= lastCharacter; c++) {
+		if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
+			std::cout << "ERROR::FREETYTPE: Failed to load Glyph " << c << std::endl;
+			continue;
+		}
+
+		const FT_Bitmap& bitmap = face->glyph->bitmap;
+		CompiledGlyph glyph = {};
+		glyph.character = c;
+		glyph.width = (int16_t)bitmap.width;
+		glyph.height = (int16_t)bitmap.rows;
+		glyph.bearingX = (int16_t)face->glyph->bitmap_left;
+		glyph.bearingY = (int16_t)face->glyph->bitmap_top;
+		glyph.advance = (int32_t)face->glyph->advance.x;
+		glyphs.push_back(glyph);
+
+		std::vector<unsigned char> pixels(bitmap.width * bitmap.rows);
+		for (unsigned int row = 0; row < bitmap.rows; row++)
+			std::memcpy(pixels.data() + row * bitmap.width, bitmap.buffer + row * bitmap.pitch, bitmap.width);
+		bitmaps.push_back(pixels);
+	}
+
+	// Kerning pairs (only the ones that change anything)
+	std::vector<CompiledKerningPair> kerningPairs;
+	if (FT_HAS_KERNING(face)) {
+		for (const CompiledGlyph& left : glyphs) {
+			for (const CompiledGlyph& right : glyphs) {
+				FT_Vector delta;
+				FT_Get_Kerning(face, FT_Get_Char_Index(face, left.character), FT_Get_Char_Index(face, right.character), FT_KERNING_DEFAULT, &delta);
+				if (delta.x != 0) kerningPairs.push_back({left.character, right.character, (int32_t)delta.x});
+			}
+		}
+	}
+	FT_Done_Face(face);
+	FT_Done_FreeType(ft);
+
+	// Shelf packing, doubling the atlas width until everything fits in a square-ish atlas
+	std::vector<size_t> order(glyphs.size());
+	for (size_t i = 0; i < order.size(); i++) order[i] = i;
+	std::sort(order.begin(), order.end(), [&glyphs](size_t a, size_t b) {return glyphs[a].height > glyphs[b].height;});
+
+	uint32_t atlasWidth = 64, atlasHeight = 0;
+	while (true) {
+		int x = padding, y = padding, shelfHeight = 0;
+		for (size_t i : order) {
+			CompiledGlyph& glyph = glyphs[i];
+			if (x + glyph.width + padding > (int)atlasWidth) {
+				x = padding;
+				y += shelfHeight + padding;
+				shelfHeight = 0;
+			}
+			glyph.atlasX = (uint16_t)x;
+			glyph.atlasY = (uint16_t)y;
+			x += glyph.width + padding;
+			shelfHeight = std::max(shelfHeight, (int)glyph.height);
+		}
+		atlasHeight = y + shelfHeight + padding;
+		if (atlasHeight <= atlasWidth) break;
+		atlasWidth *= 2;
+	}
+
+	std::vector<unsigned char> atlas(atlasWidth * atlasHeight, 0);
+	for (size_t i = 0; i < glyphs.size(); i++)
+		for (int row = 0; row < glyphs[i].height; row++)
+			std::memcpy(&atlas[(glyphs[i].atlasY + row) * atlasWidth + glyphs[i].atlasX], bitmaps[i].data() + row * glyphs[i].width, glyphs[i].width);
+
+	// Write header, tables & atlas
+	CompiledFontHeader header = {};
+	std::memcpy(header.magic, "FNTA", 4);
+	header.version = compiledFontVersion;
+	header.pixelHeight = pixelHeight;
+	header.atlasWidth = atlasWidth;
+	header.atlasHeight = atlasHeight;
+	header.numOfGlyphs = (uint32_t)glyphs.size();
+	header.numOfKerningPairs = (uint32_t)kerningPairs.size();
+	header.glyphsOffset = sizeof(CompiledFontHeader);
+	header.kerningOffset = header.glyphsOffset + glyphs.size() * sizeof(CompiledGlyph);
+	header.pixelsOffset = header.kerningOffset + kerningPairs.size() * sizeof(CompiledKerningPair);
+
+	std::ofstream fontStream(outputPath, std::ios::binary);
+	fontStream.write((const char*)&header, sizeof(header));
+	fontStream.write((const char*)glyphs.data(), glyphs.size() * sizeof(CompiledGlyph));
+	fontStream.write((const char*)kerningPairs.data(), kerningPairs.size() * sizeof(CompiledKerningPair));
+	fontStream.write((const char*)atlas.data(), atlas.size());
+	if (!fontStream) {
+		std::cout << "ERROR::FONT::FILE_NOT_SUCCESSFULLY_WRITTEN: " << outputPath << std::endl;
+		return false;
+	}
+
+	std::cout << "Baked " << glyphs.size() << " glyphs, " << kerningPairs.size() << " kerning pairs into a " << atlasWidth << "x" << atlasHeight << " atlas -> " << outputPath << std::endl;
+	return true;
+}
+
+// Packs every file under root/subdirectory into one archive. Entries are stored
+// LZ4 compressed when that saves at least an eighth, otherwise as is (so they
+// can be used straight from the mapped pack).
+bool BuildPack(const char* outputPath, const char* rootPath, const std::vector<std::string>& subdirectories) {
+	namespace fs = std::filesystem;
+
+	// collect files, with paths relative to the root as the game asks for them
+	std::vector<std::string> paths;
+	for (const std::string& subdirectory : subdirectories) {
+		fs::path directory = fs::path(rootPath) / subdirectory;
+		if (!fs::is_directory(directory)) {
+			std::cout << "ERROR::PACK::NOT_A_DIRECTORY: " << directory.string() << std::endl;
+			return false;
+		}
+		for (const fs::directory_entry& file : fs::recursive_directory_iterator(directory)) {
+			if (!file.is_regular_file()) continue;
+			std::string relative = fs::relative(file.path(), rootPath).generic_string();
+			if (relative.size() >= sizeof(AssetPackEntry::path)) {
+				std::cout << "ERROR::PACK::PATH_TOO_LONG: " << relative << std::endl;
+				return false;
+			}
+			paths.push_back(relative);
+		}
+	}
+	std::sort(paths.begin(), paths.end()); // the game binary searches the entry table
+
+	std::vector<AssetPackEntry> entries(paths.size());
+	std::vector<std::vector<unsigned char>> contents(paths.size());
+	uint64_t offset = (sizeof(AssetPackHeader) + paths.size() * sizeof(AssetPackEntry) + assetPackAlignment - 1) / assetPackAlignment * assetPackAlignment;
+	size_t totalSize = 0, totalStored = 0;
+
+	for (size_t i = 0; i < paths.size(); i++) {
+		std::ifstream fileStream(fs::path(rootPath) / paths[i], std::ios::binary);
+		std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(fileStream)), std::istreambuf_iterator<char>());
+
+		AssetPackEntry& entry = entries[i];
+		std::memset(&entry, 0, sizeof(entry));
+		std::strncpy(entry.path, paths[i].c_str(), sizeof(entry.path) - 1);
+		entry.size = (uint32_t)bytes.size();
+		entry.hash = HashBytes(bytes.data(), bytes.size());
+
+		std::vector<unsigned char> compressed(Lz4CompressBound((int)bytes.size()));
+		int compressedSize = Lz4Compress(bytes.data(), (int)bytes.size(), compressed.data(), (int)compressed.size());
+		if (compressedSize > 0 && compressedSize <= (int)(bytes.size() - bytes.size() / 8)) {
+			compressed.resize(compressedSize);
+			contents[i].swap(compressed);
+			entry.flags = assetCompressedFlag;
+		} else {
+			contents[i].swap(bytes);
+		}
+
+		entry.storedSize = (uint32_t)contents[i].size();
+		entry.offset = offset;
+		offset = (offset + entry.storedSize + assetPackAlignment - 1) / assetPackAlignment * assetPackAlignment;
+		totalSize += entry.size;
+		totalStored += entry.storedSize;
+	}
+
+	AssetPackHeader header = {};
+	std::memcpy(header.magic, "APAK", 4);
+	header.version = assetPackVersion;
+	header.numOfEntries = (uint32_t)entries.size();
+	header.entriesOffset = sizeof(AssetPackHeader);
+
+	std::vector<unsigned char> pack((size_t)offset, 0);
+	std::memcpy(&pack[0], &header, sizeof(header));
+	if (!entries.empty()) std::memcpy(&pack[(size_t)header.entriesOffset], entries.data(), entries.size() * sizeof(AssetPackEntry));
+	for (size_t i = 0; i < entries.size(); i++)
+		if (!contents[i].empty()) std::memcpy(&pack[(size_t)entries[i].offset], contents[i].data(), contents[i].size());
+
+	std::ofstream packStream(outputPath, std::ios::binary);
+	packStream.write((const char*)pack.data(), pack.size());
+	if (!packStream) {
+		std::cout << "ERROR::PACK::FILE_NOT_SUCCESSFULLY_WRITTEN: " << outputPath << std::endl;
+		return false;
+	}
+
+	std::cout << "Packed " << entries.size() << " files, " << totalSize << " -> " << totalStored << " bytes -> " << outputPath << std::endl;
+	return true;
+}
+
+// Simulates the jump arcs of every platform ahead of time, so the game only loads the graph
+bool BuildNavGraph(const char* inputPath, float radius, double ticksPerSecond, const char* outputPath) {
+	Level level;
+	if (!level.Load(inputPath)) return false;
+
+	ThreadPool pool;
+	pool.Setup();
+	NavGraph graph;
+	graph.Build(level, PlayerPhysics::Parameters(radius, level), (float)(1.0 / ticksPerSecond), &pool);
+	pool.Shutdown();
+	if (!graph.Save(outputPath)) return false;
+
+	int numOfLinks = 0;
+	for (int i = 0; i < graph.NumOfNodes(); i++) numOfLinks += graph.GetNode(i).numOfLinks;
+	std::cout << "Built " << graph.NumOfNodes() << " nodes, " << numOfLinks << " links -> " << outputPath << std::endl;
+	return true;
+}
+
+bool CompileTileMap(const char* inputPath, const char* outputPath) {
+	TileMap tileMap;
+	if (!tileMap.Load(inputPath)) return false;
+	if (!tileMap.SaveCompiled(outputPath)) return false;
+
+	std::cout << "Compiled a " << tileMap.Width() << "x" << tileMap.Height() << " tile map -> " << outputPath << std::endl;
+	return true;
+}
@@ -0,0 +1,461 @@
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+#include <GLM/glm.hpp>
+
+#include "Level.h"
+#include "TileMap.h"
+#include "PlayerPhysics.h"
+#include "BatchEnvironment.h"
+#include "ThreadPool.h"
+
+// Checks that the shared physics still moves the player exactly like the
+// original Player did and that tile maps collide like their cells, then
+// measures how fast BatchEnvironment steps and tile map queries run.
+//   PhysicsTests [level.lvl]
+// Exits with 1 when any tick differs.
+
+// Functions
+void MakeCrowdedLevel(Level &level, uint32_t seed);
+bool CompareWithReference(const Level &level, const char* name);
+bool CompareBatchWithReference(const Level &level, ThreadPool &pool, const char* name);
+void BenchmarkBatch(const Level &level, ThreadPool &pool);
+void MakeRandomTileMap(TileMap &map, int width, int height, uint32_t seed);
+bool CompareTileQueries();
+bool RollOverTiles();
+void BenchmarkTileQueries();
+
+const float circleRadius = 0.07f;
+const double ticksPerSecond = 60.0;
+
+
+// The player's Update, Move & collision code as it was before PlayerPhysics,
+// kept word for word (walls at -1 & 1, ceiling at 1) as the reference
+struct ReferencePlayer {
+	float circleRadius;
+	glm::vec3 playerPosition;
+	float timer = 0.0f;
+	bool tired = false;
+	float speedup = 0.0f;
+	float hyperTime = 2.0f;
+	float cooldownTime = 3.0f;
+	float velocityY = 0.0f;
+	const float velocityX = 0.5f;
+	const float gravity = 4.0f;
+	const float kickoff = 2.24f;
+	float lowestPoint, highestPoint;
+	bool onGround = false;
+	float closestX, closestY, distanceX, distanceY;
+
+	void Setup(float radius, const Level &level) {
+		circleRadius = radius;
+		playerPosition = glm::vec3(level.spawnPoint, 0.0f);
+		highestPoint = 1.0f - circleRadius;
+		lowestPoint = level.groundUpperline + circleRadius;
+	}
+
+	// BatchEnvironment's reset of a finished episode
+	void Respawn(const Level &level) {
+		Setup(circleRadius, level);
+		timer = 0.0f, tired = false, speedup = 0.0f, velocityY = 0.0f, onGround = false;
+	}
+
+	void Input(unsigned int inputBits, float deltaTime) {
+		if (inputBits & INPUT_UP)    Move(UP, deltaTime);
+		if (inputBits & INPUT_RIGHT) Move(RIGHT, deltaTime);
+		if (inputBits & INPUT_LEFT)  Move(LEFT, deltaTime);
+		if (inputBits & INPUT_HYPER) {if (!tired) speedup = 0.5f;}
+		else speedup = 0.0f, timer = 0.0f;
+	}
+
+	void Move(Player_Movement key, float deltaTime) {
+		if (key == UP && onGround) velocityY = kickoff + speedup;
+		if (key == RIGHT) playerPosition.x += (velocityX + speedup) * deltaTime;
+		if (key == LEFT)  playerPosition.x -= (velocityX + speedup) * deltaTime;
+	}
+
+	void Update(float deltaTime, const Level &level) {
+		playerPosition.x = glm::max(-1.0f + circleRadius, glm::min(1.0f - circleRadius, playerPosition.x));
+		playerPosition.y = glm::min(highestPoint, glm::max(playerPosition.y + velocityY * deltaTime, lowestPoint));
+
+		onGround = false;
+		if (playerPosition.y == lowestPoint) onGround = true;
+
+		if (speedup > 0.1f) {
+			timer += deltaTime;
+			if (timer > hyperTime) tired = true, speedup = 0.0f, timer = 0.0f;
+		}
+		if (tired) {
+			timer += deltaTime;
+			if (timer > cooldownTime) tired = false, timer = 0.0f;
+		}
+
+		for (int i = 0; i < level.NumOfPlatforms(); i++) {
+			if (playerPosition.x + circleRadius < level.platformsLeft[i] || playerPosition.x - circleRadius > level.platformsRight[i]) continue;
+			Collider platform = level.GetCollider(i);
+			if (DetectCollision(platform)) Collide(platform);
+		}
+
+		if (onGround)                              velocityY = 0.0f;
+		else if (playerPosition.y == highestPoint) velocityY = glm::min(0.0f, velocityY - gravity * deltaTime);
+		else                                       velocityY -= gravity * deltaTime;
+	}
+
+	bool DetectCollision(const Collider &platform) {
+		closestX = glm::max(platform.leftSide,  glm::min(playerPosition.x, platform.rightSide));
+		closestY = glm::max(platform.lowerSide, glm::min(playerPosition.y, platform.upperSide));
+		distanceX = playerPosition.x - closestX;
+		distanceY = playerPosition.y - closestY;
+		float distanceSquare = (distanceX * distanceX) + (distanceY * distanceY);
+		return (distanceSquare < (circleRadius * circleRadius));
+	}
+
+	void Collide(const Collider &platform) {
+		float radiusSquare = circleRadius * circleRadius;
+		if (closestY == platform.upperSide && glm::abs(distanceX) < (0.5f * circleRadius)) {
+			if (closestX == platform.leftSide) {
+				float firstTerm = (playerPosition.x - platform.leftSide) * (playerPosition.x - platform.leftSide);
+				playerPosition.y = glm::sqrt(radiusSquare - firstTerm) + platform.upperSide;
+			} else if (closestX == platform.rightSide) {
+				float firstTerm = (playerPosition.x - platform.rightSide) * (playerPosition.x - platform.rightSide);
+				playerPosition.y = glm::sqrt(radiusSquare - firstTerm) + platform.upperSide;
+			} else {
+				playerPosition.y = glm::max(playerPosition.y, platform.upperSide + circleRadius);
+			}
+			onGround = true;
+		} else if (closestY == platform.lowerSide) {
+			velocityY = glm::min(velocityY, 0.0f);
+			if (closestX == platform.leftSide) {
+				float firstTerm = (playerPosition.x - platform.leftSide) * (playerPosition.x - platform.leftSide);
+				playerPosition.y = -glm::sqrt(radiusSquare - firstTerm) + platform.lowerSide;
+			} else if (closestX == platform.rightSide) {
+				float firstTerm = (playerPosition.x - platform.rightSide) * (playerPosition.x - platform.rightSide);
+				playerPosition.y = -glm::sqrt(radiusSquare - firstTerm) + platform.lowerSide;
+			} else {
+				playerPosition.y = glm::min(playerPosition.y, platform.lowerSide - circleRadius);
+			}
+		} else if (closestX == platform.leftSide) {
+			playerPosition.x = platform.leftSide - circleRadius;
+		} else if (closestX == platform.rightSide) {
+			playerPosition.x = platform.rightSide + circleRadius;
+		}
+	}
+};
+
+// Random key presses held for a few ticks, like a player (or an agent) would
+struct ActionStream {
+	uint32_t state;
+	unsigned int action = 0;
+	int ticksLeft = 0;
+
+	unsigned int Next() {
+		if (ticksLeft-- <= 0) {
+			action = Random() & (INPUT_UP | INPUT_RIGHT | INPUT_LEFT | INPUT_HYPER);
+			ticksLeft = Random() % 40;
+		}
+		return action;
+	}
+
+	uint32_t Random() {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+};
+
+static bool SameBits(float a, float b) {return std::memcmp(&a, &b, sizeof(float)) == 0;}
+
+
+
+int main(int argc, char** argv) {
+	const char* levelPath = argc > 1 ? argv[1] : "2D_Platformer/Resources/levels/level1.lvl";
+
+	Level level;
+	if (!level.Load(levelPath)) return 1;
+	Level crowded;
+	MakeCrowdedLevel(crowded, 7);
+
+	ThreadPool pool;
+	pool.Setup();
+
+	bool passed = CompareWithReference(level, levelPath) && CompareWithReference(crowded, "crowded level");
+	passed = CompareBatchWithReference(level, pool, levelPath) && passed;
+	passed = CompareTileQueries() && passed;
+	passed = RollOverTiles() && passed;
+	BenchmarkBatch(level, pool);
+	BenchmarkTileQueries();
+
+	pool.Shutdown();
+	std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+	return passed ? 0 : 1;
+}
+
+
+
+// More than a query buffer's worth of platforms over every x, so any collider dropped by a query shows up
+void MakeCrowdedLevel(Level & level, uint32_t seed) {
+	ActionStream random = {seed};
+	level.Reserve(300);
+	for (int i = 0; i < 300; i++) {
+		glm::vec2 center = glm::vec2((random.Random() % 2000) / 1000.0f - 1.0f, (random.Random() % 1800) / 1000.0f - 0.8f);
+		glm::vec2 size = glm::vec2(0.05f + (random.Random() % 300) / 1000.0f, 0.02f + (random.Random() % 80) / 1000.0f);
+		level.AddPlatform(center, size);
+	}
+}
+
+// Every tick of many random runs must match the reference bit for bit
+bool CompareWithReference(const Level & level, const char* name) {
+	const int runs = 256, ticks = 3600;
+	float tickDelta = (float)(1.0 / ticksPerSecond);
+	PlayerParameters parameters = PlayerPhysics::Parameters(circleRadius, level);
+
+	for (int run = 0; run < runs; run++) {
+		ActionStream actions = {0x9E3779B9u + run * 7919u};
+		ReferencePlayer reference;
+		reference.Setup(circleRadius, level);
+		PlayerState state = PlayerPhysics::Spawn(level);
+
+		for (int tick = 0; tick < ticks; tick++) {
+			unsigned int action = actions.Next();
+			reference.Input(action, tickDelta);
+			reference.Update(tickDelta, level);
+			PlayerPhysics::ApplyInput(state, parameters, action, tickDelta);
+			PlayerPhysics::Update(state, parameters, tickDelta, level);
+
+			if (!SameBits(state.position.x, reference.playerPosition.x) || !SameBits(state.position.y, reference.playerPosition.y) ||
+			    !SameBits(state.velocityY, reference.velocityY) || state.onGround != reference.onGround) {
+				printf("ERROR::PHYSICS::MISMATCH: %s run %d tick %d: (%.9g, %.9g) vy %.9g, reference (%.9g, %.9g) vy %.9g\n", name, run, tick,
+				       state.position.x, state.position.y, state.velocityY, reference.playerPosition.x, reference.playerPosition.y, reference.velocityY);
+				return false;
+			}
+		}
+	}
+	printf("%s: %d runs x %d ticks match the reference\n", name, runs, ticks);
+	return true;
+}
+
+// The batched instances must see the same positions as reference players given the same actions
+bool CompareBatchWithReference(const Level & level, ThreadPool & pool, const char* name) {
+	const int instances = 4096, steps = 1200;
+	BatchEnvironment environment;
+	if (!environment.Setup(&level, &pool, instances, circleRadius, ticksPerSecond, 600)) return false;
+
+	std::vector<ReferencePlayer> references(instances);
+	std::vector<ActionStream> streams(instances);
+	std::vector<unsigned int> actions(instances);
+	std::vector<float> observations(instances * BatchEnvironment::observationSize), rewards(instances);
+	std::vector<unsigned char> dones(instances);
+	for (int i = 0; i < instances; i++) references[i].Setup(circleRadius, level), streams[i].state = 12345u + i;
+	environment.Reset(observations.data());
+
+	float tickDelta = (float)(1.0 / ticksPerSecond);
+	for (int step = 0; step < steps; step++) {
+		for (int i = 0; i < instances; i++) actions[i] = streams[i].Next();
+		environment.Step(actions.data(), observations.data(), rewards.data(), dones.data());
+
+		for (int i = 0; i < instances; i++) {
+			ReferencePlayer& reference = references[i];
+			reference.Input(actions[i], tickDelta);
+			reference.Update(tickDelta, level);
+			if (dones[i]) {
+				reference.Respawn(level);
+			}
+
+			const float* observation = &observations[i * BatchEnvironment::observationSize];
+			if (!SameBits(observation[BatchEnvironment::OBS_POSITION_X], reference.playerPosition.x) ||
+			    !SameBits(observation[BatchEnvironment::OBS_POSITION_Y], reference.playerPosition.y)) {
+				printf("ERROR::BATCH::MISMATCH: %s instance %d step %d\n", name, i, step);
+				return false;
+			}
+		}
+	}
+	printf("%s: %d batched instances x %d steps match the reference\n", name, instances, steps);
+	return true;
+}
+
+// Instance steps per second over the whole batch, observations included
+void BenchmarkBatch(const Level & level, ThreadPool & pool) {
+	const int instances = 65536, steps = 200;
+	BatchEnvironment environment;
+	if (!environment.Setup(&level, &pool, instances, circleRadius, ticksPerSecond, 600)) return;
+
+	std::vector<ActionStream> streams(instances);
+	std::vector<unsigned int> actions(instances);
+	std::vector<float> observations(instances * BatchEnvironment::observationSize), rewards(instances);
+	std::vector<unsigned char> dones(instances);
+	for (int i = 0; i < instances; i++) streams[i].state = 777u + i;
+	environment.Reset(observations.data());
+
+	double seconds = 0.0;
+	for (int step = 0; step < steps; step++) {
+		for (int i = 0; i < instances; i++) actions[i] = streams[i].Next();
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		environment.Step(actions.data(), observations.data(), rewards.data(), dones.data());
+		seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+	printf("BatchEnvironment: %.2f million instance steps per second (%d instances, %u worker threads)\n",
+	       instances * (double)steps / seconds / 1.0e6, instances, pool.NumOfThreads());
+}
+
+
+
+// Cells of the given density, solid & one-way mixed in horizontal streaks so runs get merged
+void MakeRandomTileMap(TileMap & map, int width, int height, uint32_t seed) {
+	ActionStream random = {seed};
+	map.origin = glm::vec2(-1.0f, -1.0f);
+	map.cellSize = 0.0625f; // exact in binary, so colliders map back to whole cells
+	map.Resize(width, height);
+	int density = 1 + random.Random() % 6;
+	for (int y = 0; y < height; y++) {
+		Tile_Type type = TILE_EMPTY;
+		for (int x = 0; x < width; x++) {
+			if (random.Random() % 8 == 0) type = random.Random() % 8 < (uint32_t)density ? (Tile_Type)(1 + random.Random() % 2) : TILE_EMPTY;
+			map.SetCell(x, y, type);
+		}
+	}
+}
+
+// Every query must cover exactly the cells a brute-force walk over the whole map
+// finds, each once, with solid and one-way colliders made only of their own type
+bool CompareTileQueries() {
+	const int maps = 40, queriesPerMap = 500;
+	std::vector<Collider> colliders(4096), small(5);
+
+	for (int m = 0; m < maps; m++) {
+		ActionStream random = {1000u + m};
+		TileMap map;
+		MakeRandomTileMap(map, 1 + random.Random() % 150, 1 + random.Random() % 100, 2000u + m);
+		Collider bounds = map.Bounds();
+		std::vector<int> covered(map.Width() * map.Height());
+
+		for (int q = 0; q < queriesPerMap; q++) {
+			glm::vec2 center = glm::vec2(bounds.leftSide - 0.2f + (random.Random() % 10000) / 10000.0f * (bounds.rightSide - bounds.leftSide + 0.4f),
+			                             bounds.lowerSide - 0.2f + (random.Random() % 10000) / 10000.0f * (bounds.upperSide - bounds.lowerSide + 0.4f));
+			float reach = 0.01f + (random.Random() % 1000) / 1000.0f * 0.6f;
+			float velocityY = (random.Random() % 3 == 0) ? 1.0f : -1.0f;
+
+			glm::ivec2 lowest = map.CellAt(center - glm::vec2(reach)), highest = map.CellAt(center + glm::vec2(reach));
+			int count = map.QueryColliders(center, reach, velocityY, colliders.data(), (int)colliders.size());
+			std::fill(covered.begin(), covered.end(), 0);
+			bool valid = count <= (int)colliders.size();
+			for (int i = 0; i < count && valid; i++) {
+				const Collider& collider = colliders[i];
+				int left = (int)std::lround((collider.leftSide - map.origin.x) / map.cellSize), right = (int)std::lround((collider.rightSide - map.origin.x) / map.cellSize);
+				int lower = (int)std::lround((collider.lowerSide - map.origin.y) / map.cellSize), upper = (int)std::lround((collider.upperSide - map.origin.y) / map.cellSize);
+				Tile_Type type = map.GetCell(left, lower);
+				valid = type != TILE_EMPTY && left < right && lower < upper && (type == TILE_SOLID || upper == lower + 1);
+				// runs are as long as the reach allows, solid ones as tall as identical runs allow
+				valid = valid && (left == glm::max(lowest.x, 0) || map.GetCell(left - 1, lower) != type);
+				valid = valid && (right == glm::min(highest.x, map.Width() - 1) + 1 || map.GetCell(right, lower) != type);
+				for (int j = 0; j < count && valid && type == TILE_SOLID && map.GetCell(left, upper) == TILE_SOLID; j++) {
+					const Collider& other = colliders[j];
+					valid = other.leftSide != collider.leftSide || other.rightSide != collider.rightSide || other.lowerSide != collider.upperSide;
+				}
+				for (int y = lower; y < upper && valid; y++) {
+					for (int x = left; x < right && valid; x++) {
+						valid = map.GetCell(x, y) == type && covered[y * map.Width() + x] == 0;
+						if (valid) covered[y * map.Width() + x] = 1;
+					}
+				}
+			}
+
+			// brute force over every cell of the map
+			for (int y = 0; y < map.Height() && valid; y++) {
+				for (int x = 0; x < map.Width() && valid; x++) {
+					Tile_Type type = map.GetCell(x, y);
+					bool inReach = x >= lowest.x && x <= highest.x && y >= lowest.y && y <= highest.y;
+					bool expected = inReach && (type == TILE_SOLID || (type == TILE_ONE_WAY && velocityY <= 0.0f && center.y >= map.CellBounds(x, y).upperSide));
+					valid = expected == (covered[y * map.Width() + x] == 1);
+				}
+			}
+
+			// a small buffer still reports enough room for all of them
+			int smallCount = map.QueryColliders(center, reach, velocityY, small.data(), (int)small.size());
+			valid = valid && smallCount >= count;
+
+			if (!valid) {
+				printf("ERROR::TILE_MAP::QUERY_MISMATCH: map %d (%d x %d) query %d at (%.4f, %.4f) reach %.4f\n", m, map.Width(), map.Height(), q, center.x, center.y, reach);
+				return false;
+			}
+		}
+	}
+	printf("tile maps: %d random maps x %d queries match the brute-force cells\n", maps, queriesPerMap);
+	return true;
+}
+
+// A player rolls along a floor of cells without catching on the seams between
+// them, jumps up through a row of one-way cells and lands on top of it
+bool RollOverTiles() {
+	const float tickDelta = (float)(1.0 / ticksPerSecond);
+	TileMap map;
+	map.origin = glm::vec2(-1.0f, -1.0f);
+	map.cellSize = 0.0625f;
+	map.Resize(64, 32);
+	for (int x = 0; x < 64; x++) map.SetCell(x, 2, TILE_SOLID);
+	for (int x = 20; x <= 40; x++) map.SetCell(x, 8, TILE_ONE_WAY);
+	float floorTop = map.CellBounds(0, 2).upperSide, oneWayTop = map.CellBounds(0, 8).upperSide;
+	PlayerParameters parameters = PlayerPhysics::Parameters(circleRadius, map);
+
+	// fall onto the floor, then roll right over 45 cell seams
+	PlayerState state;
+	state.position = glm::vec2(-0.9f, -0.5f);
+	for (int tick = 0; tick < 60; tick++) PlayerPhysics::Update(state, parameters, tickDelta, map);
+	for (int tick = 0; tick < 360; tick++) {
+		float lastX = state.position.x;
+		PlayerPhysics::ApplyInput(state, parameters, INPUT_RIGHT, tickDelta);
+		PlayerPhysics::Update(state, parameters, tickDelta, map);
+		if (!state.onGround || std::fabs(state.position.y - (floorTop + circleRadius)) > 1e-5f ||
+		    std::fabs(state.position.x - lastX - parameters.velocityX * tickDelta) > 1e-5f) {
+			printf("ERROR::TILE_MAP::ROLL: tick %d at (%.6f, %.6f)\n", tick, state.position.x, state.position.y);
+			return false;
+		}
+	}
+
+	// from the floor under the one-way row: up through it, then down onto it
+	state = PlayerState();
+	state.position = glm::vec2(map.CellBounds(30, 0).leftSide, floorTop + circleRadius);
+	PlayerPhysics::Update(state, parameters, tickDelta, map);
+	PlayerPhysics::ApplyInput(state, parameters, INPUT_UP, tickDelta);
+	float highest = state.position.y;
+	for (int tick = 0; tick < 120; tick++) {
+		PlayerPhysics::Update(state, parameters, tickDelta, map);
+		highest = glm::max(highest, state.position.y);
+	}
+	if (highest < oneWayTop + circleRadius || !state.onGround || std::fabs(state.position.y - (oneWayTop + circleRadius)) > 1e-5f) {
+		printf("ERROR::TILE_MAP::ONE_WAY: highest %.6f, ended at %.6f on ground %d\n", highest, state.position.y, state.onGround);
+		return false;
+	}
+	printf("tile maps: rolled over cell seams and landed on a one-way row\n");
+	return true;
+}
+
+// The same player-sized query on a small and a huge map should cost about the same
+void BenchmarkTileQueries() {
+	const int sizes[2] = {256, 8192}, queries = 1000000;
+	Collider colliders[64];
+	for (int size : sizes) {
+		TileMap map;
+		MakeRandomTileMap(map, size, size, 99u);
+		Collider bounds = map.Bounds();
+		ActionStream random = {5u};
+		std::vector<glm::vec2> centers(4096);
+		for (glm::vec2& center : centers) {
+			center = glm::vec2(bounds.leftSide + (random.Random() % 100000) / 100000.0f * (bounds.rightSide - bounds.leftSide),
+			                   bounds.lowerSide + (random.Random() % 100000) / 100000.0f * (bounds.upperSide - bounds.lowerSide));
+		}
+
+		int total = 0;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (int q = 0; q < queries; q++) total += map.QueryColliders(centers[q % centers.size()], 3.0f * circleRadius, -1.0f, colliders, 64);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		printf("TileMap: %.3f us per player query on a %d x %d map (%.1f colliders on average)\n",
+		       seconds / queries * 1.0e6, size, size, total / (double)queries);
+	}
+}
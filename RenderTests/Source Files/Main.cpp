@@ -0,0 +1,308 @@
+#include <GLAD/glad.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include <chrono>
+#include <iostream>
+
+#include <GLM/glm.hpp>
+#include <GLM/gtc/matrix_transform.hpp>
+
+#include "TileMap.h"
+#include "TileMapRenderer.h"
+#include "ParticleSystem.h"
+#include "GpuParticleSystem.h"
+#include "ShaderProgram.h"
+
+// Runs the game's GL code on a surfaceless EGL context, so it needs no window
+// or GPU (Mesa's llvmpipe is enough), and checks what it rendered or computed
+// against the CPU.
+//   RenderTests
+// Run from the repository root. Exits with 1 when any check fails.
+
+// Functions
+bool CreateContext();
+bool CheckTileMapRenderer();
+bool CheckGpuParticles();
+bool BenchmarkParticleSystem();
+
+const int frameSize = 256; // pixels, the framebuffer is square
+
+
+// xorshift, the same maps on every run
+struct TestRandom {
+	uint32_t state;
+
+	uint32_t Next() {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+};
+
+static std::vector<unsigned char> ReadFrame() {
+	std::vector<unsigned char> pixels(frameSize * frameSize * 4);
+	glReadPixels(0, 0, frameSize, frameSize, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+	return pixels;
+}
+
+static bool CheckGLErrors(const char* name) {
+	GLenum error = glGetError();
+	if (error == GL_NO_ERROR) return true;
+	printf("ERROR::RENDER_TESTS::GL_ERROR: 0x%x in %s\n", error, name);
+	return false;
+}
+
+
+
+int main() {
+	if (!CreateContext()) return 1;
+	printf("%s, %s\n", (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION));
+
+	bool passed = CheckTileMapRenderer();
+	passed = CheckGpuParticles() && passed;
+	passed = BenchmarkParticleSystem() && passed;
+
+	std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+	return passed ? 0 : 1;
+}
+
+
+
+// GL 3.3 core on the Mesa surfaceless platform, drawing into a frameSize^2 RGBA framebuffer
+bool CreateContext() {
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	EGLDisplay display = getPlatformDisplay ? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr) : EGL_NO_DISPLAY;
+	EGLint major, minor;
+	if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor) || !eglBindAPI(EGL_OPENGL_API)) {
+		std::cout << "ERROR::RENDER_TESTS::NO_SURFACELESS_EGL" << std::endl;
+		return false;
+	}
+
+	const EGLint contextAttributes[] = {EGL_CONTEXT_MAJOR_VERSION, 3, EGL_CONTEXT_MINOR_VERSION, 3,
+	                                    EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, EGL_NONE};
+	EGLContext context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttributes);
+	if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+		std::cout << "ERROR::RENDER_TESTS::NO_GL_3_3_CONTEXT" << std::endl;
+		return false;
+	}
+	if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) {
+		std::cout << "ERROR::RENDER_TESTS::GLAD_FAILED" << std::endl;
+		return false;
+	}
+
+	unsigned int framebuffer, colorBuffer;
+	glGenFramebuffers(1, &framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glGenRenderbuffers(1, &colorBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, frameSize, frameSize);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+	glViewport(0, 0, frameSize, frameSize);
+	return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE && CheckGLErrors("CreateContext");
+}
+
+// A big random map drawn through a small view must match the cells under every
+// pixel, in a few draws; an edited cell must show once rebaked, and a view off
+// the map must not draw at all
+bool CheckTileMapRenderer() {
+	TileMap map;
+	map.origin = glm::vec2(-1.0f, -1.0f);
+	map.cellSize = 0.0625f; // 8 pixels a cell below, no pixel center on a cell edge
+	map.Resize(2000, 200);
+	TestRandom random = {2024u};
+	for (int y = 0; y < map.Height(); y++) {
+		Tile_Type type = TILE_EMPTY;
+		for (int x = 0; x < map.Width(); x++) {
+			if (random.Next() % 6 == 0) type = (Tile_Type)(random.Next() % 3);
+			map.SetCell(x, y, type);
+		}
+	}
+
+	ShaderSources sources;
+	if (!ShaderProgram::ReadSources("2D_Platformer/Shaders/tileShader.vs", "2D_Platformer/Shaders/tileShader.fs", nullptr, sources)) return false;
+	TileMapRenderer renderer;
+	renderer.Setup(sources);
+	renderer.Upload(map);
+
+	glm::vec4 region = glm::vec4(20.0f, 2.0f, 22.0f, 4.0f); // left, bottom, right, top
+	glm::mat4 viewProjection = glm::ortho(region.x, region.z, region.y, region.w);
+
+	// what every pixel should be: the cell under its center
+	auto matchesCells = [&](const char* name) {
+		std::vector<unsigned char> pixels = ReadFrame();
+		for (int py = 0; py < frameSize; py++) {
+			for (int px = 0; px < frameSize; px++) {
+				glm::vec2 center = glm::vec2(region.x, region.y) + (glm::vec2(px, py) + 0.5f) / (float)frameSize * glm::vec2(region.z - region.x, region.w - region.y);
+				glm::ivec2 cell = map.CellAt(center);
+				Tile_Type type = map.GetCell(cell.x, cell.y);
+				glm::ivec3 expected = type == TILE_SOLID ? glm::ivec3(0, 0, 255) : type == TILE_ONE_WAY ? glm::ivec3(102, 153, 255) : glm::ivec3(0);
+				const unsigned char* pixel = &pixels[(py * frameSize + px) * 4];
+				if (std::abs(pixel[0] - expected.r) > 1 || std::abs(pixel[1] - expected.g) > 1 || std::abs(pixel[2] - expected.b) > 1) {
+					printf("ERROR::TILE_MAP_RENDERER::WRONG_PIXEL: %s (%d, %d) is (%d, %d, %d), cell (%d, %d) type %d\n",
+					       name, px, py, pixel[0], pixel[1], pixel[2], cell.x, cell.y, type);
+					return false;
+				}
+			}
+		}
+		return true;
+	};
+
+	// baked ahead, as when the chunks load
+	renderer.BakeRegion(region);
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+	renderer.Draw(region, viewProjection);
+	if (!matchesCells("first draw")) return false;
+	int drawn = renderer.NumOfDrawn();
+	if (drawn < 1 || drawn > 9) {
+		printf("ERROR::TILE_MAP_RENDERER::DRAWS: %d for one screen\n", drawn);
+		return false;
+	}
+
+	// an edit in view
+	glm::ivec2 edited = map.CellAt(glm::vec2(21.03f, 3.03f));
+	map.SetCell(edited.x, edited.y, map.GetCell(edited.x, edited.y) == TILE_SOLID ? TILE_ONE_WAY : TILE_SOLID);
+	renderer.MarkDirty(edited.x, edited.y);
+	renderer.Bake(edited.x / tileChunkSize, edited.y / tileChunkSize);
+	glClear(GL_COLOR_BUFFER_BIT);
+	renderer.Draw(region, viewProjection);
+	if (!matchesCells("after an edit")) return false;
+
+	renderer.Draw(glm::vec4(500.0f, 500.0f, 502.0f, 502.0f), viewProjection);
+	if (renderer.NumOfDrawn() != 0) {
+		printf("ERROR::TILE_MAP_RENDERER::DRAWS: %d off the map\n", renderer.NumOfDrawn());
+		return false;
+	}
+
+	renderer.DeleteVAO();
+	if (!CheckGLErrors("CheckTileMapRenderer")) return false;
+	printf("TileMapRenderer: %d x %d map matches its cells in %d draws, edits show after a rebake\n", map.Width(), map.Height(), drawn);
+	return true;
+}
+
+// Emitting, one integration step against the CPU, the spawn ring wrapping
+// around, and every particle dying before the system stops its passes, all
+// read back from the state buffer transform feedback wrote last
+bool CheckGpuParticles() {
+	ShaderSources updateSources, drawSources;
+	if (!ShaderProgram::ReadSources("2D_Platformer/Shaders/particleUpdate.vs", nullptr, nullptr, updateSources)) return false;
+	if (!ShaderProgram::ReadSources("2D_Platformer/Shaders/gpuParticleShader.vs", "2D_Platformer/Shaders/particleShader.fs", nullptr, drawSources)) return false;
+
+	ParticleMaterial material = {glm::vec4(1.0f, 0.6f, 0.2f, 1.0f), glm::vec2(-1.0f, 0.5f), glm::vec2(1.0f, 1.5f), 0.5f, 0.9f, 0.02f, 0.04f, 4.0f, 0.5f};
+	const int capacity = 4096;
+	const float tickDelta = 1.0f / 144.0f; // the longest life isn't a whole number of ticks
+	GpuParticleSystem particles;
+	particles.Setup(updateSources, drawSources, material, capacity);
+
+	std::vector<GpuParticle> state(capacity);
+	auto readBack = [&] {
+		glBindBuffer(GL_ARRAY_BUFFER, particles.StateBuffer());
+		glGetBufferSubData(GL_ARRAY_BUFFER, 0, capacity * sizeof(GpuParticle), state.data());
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		int alive = 0;
+		for (const GpuParticle& particle : state) alive += particle.life.x > 0.0f;
+		return alive;
+	};
+	auto fail = [](const char* what, double value) {
+		printf("ERROR::GPU_PARTICLES::%s: %g\n", what, value);
+		return false;
+	};
+
+	// a fresh emit: the first slots, at the emitter, with randoms in the material's ranges
+	glm::vec2 emitter = glm::vec2(0.3f, 0.2f);
+	particles.Emit(emitter, 1000);
+	particles.Update(tickDelta);
+	int alive = readBack();
+	if (alive != 1000) return fail("ALIVE_AFTER_EMIT", alive);
+	for (int i = 0; i < 1000; i++) {
+		const GpuParticle& particle = state[i];
+		glm::vec2 velocity = glm::vec2(particle.motion.z, particle.motion.w);
+		if (glm::vec2(particle.motion) != emitter || glm::any(glm::lessThan(velocity, material.minVelocity)) || glm::any(glm::greaterThan(velocity, material.maxVelocity)) ||
+		    particle.life.x < material.minLife || particle.life.x > material.maxLife || particle.life.z < material.minSize || particle.life.z > material.maxSize)
+			return fail("SPAWNED_OUT_OF_RANGE", i);
+	}
+
+	// one step, the same integration ParticleSystem runs on the CPU
+	std::vector<GpuParticle> spawned(state.begin(), state.begin() + 1000);
+	particles.Update(tickDelta);
+	readBack();
+	for (int i = 0; i < 1000; i++) {
+		glm::vec2 velocity = glm::vec2(spawned[i].motion.z, spawned[i].motion.w) * (1.0f - material.drag * tickDelta) - glm::vec2(0.0f, material.gravity * tickDelta);
+		glm::vec2 position = glm::vec2(spawned[i].motion) + velocity * tickDelta;
+		float error = glm::length(glm::vec2(state[i].motion) - position) + glm::length(glm::vec2(state[i].motion.z, state[i].motion.w) - velocity) +
+		              std::abs(state[i].life.x - (spawned[i].life.x - tickDelta));
+		if (error > 1e-5f) return fail("STEP_DIFFERS_FROM_CPU", error);
+	}
+
+	// past the end of the ring: the oldest slots restart at the new emitter
+	glm::vec2 secondEmitter = glm::vec2(-0.4f, 0.1f);
+	particles.Emit(secondEmitter, 3500);
+	particles.Update(tickDelta);
+	alive = readBack();
+	if (alive != capacity) return fail("ALIVE_AFTER_WRAP", alive);
+	int wrapped = 1000 + 3500 - capacity;
+	for (int i = 0; i < capacity; i++) {
+		bool restarted = i < wrapped || i >= 1000;
+		if ((glm::vec2(state[i].motion) == secondEmitter) != restarted) return fail("WRONG_SLOT_AFTER_WRAP", i);
+	}
+
+	// nothing may be left alive once the passes stop, not even for one more update
+	for (float time = 0.0f; time < material.maxLife + 1.0f; time += tickDelta) particles.Update(tickDelta);
+	alive = readBack();
+	if (alive != 0) return fail("ALIVE_AFTER_EXPIRY", alive);
+
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+	particles.Draw(glm::mat4(1.0f));
+	particles.DeleteVAO();
+	if (!CheckGLErrors("CheckGpuParticles")) return false;
+	printf("GpuParticleSystem: spawn, step, ring wrap-around and expiry match the CPU\n");
+	return true;
+}
+
+// CPU cost of ParticleSystem::Update with 100k dust (one effect, so one pool
+// must hold them all) plus a trail and debris. Every round is emitted fresh and
+// timed while nobody has died yet, so the count stays put.
+bool BenchmarkParticleSystem() {
+	ShaderSources sources;
+	if (!ShaderProgram::ReadSources("2D_Platformer/Shaders/particleShader.vs", "2D_Platformer/Shaders/particleShader.fs", nullptr, sources)) return false;
+	ParticleSystem particles;
+	particles.Setup(sources);
+
+	const int counts[NUM_OF_PARTICLE_MATERIALS] = {100000, 9000, 9000}; // dust, trail, debris
+	const int total = counts[PARTICLE_DUST] + counts[PARTICLE_TRAIL] + counts[PARTICLE_DEBRIS];
+	const int rounds = 10, updatesPerRound = 40; // 40 ticks are shorter than the shortest life
+	const float tickDelta = 1.0f / 144.0f;
+
+	double seconds = 0.0, slowest = 0.0;
+	for (int round = 0; round < rounds; round++) {
+		for (int material = 0; material < NUM_OF_PARTICLE_MATERIALS; material++) particles.Emit((Particle_Material)material, glm::vec2(0.0f), counts[material]);
+		if (particles.NumOfAlive() != total) {
+			printf("ERROR::PARTICLES::POOL_TOO_SMALL: %d of %d emitted\n", particles.NumOfAlive(), total);
+			return false;
+		}
+
+		for (int update = 0; update < updatesPerRound; update++) {
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			particles.Update(tickDelta);
+			double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			seconds += elapsed;
+			slowest = glm::max(slowest, elapsed);
+		}
+		if (particles.NumOfAlive() != total) {
+			printf("ERROR::PARTICLES::DIED_EARLY: %d of %d alive\n", particles.NumOfAlive(), total);
+			return false;
+		}
+		while (particles.NumOfAlive() > 0) particles.Update(tickDelta);
+	}
+
+	particles.DeleteVAO();
+	printf("ParticleSystem: %.3f ms per update for %d particles (slowest %.3f ms)\n", seconds / (rounds * updatesPerRound) * 1.0e3, total, slowest * 1.0e3);
+	return true;
+}